@@ -82,12 +82,12 @@ void setup() {
     
     if (result.success) {
         Serial.println("Time synchronized successfully!");
-        Serial.printf("Server: %s\n", result.serverUsed);
+        Serial.printf("Server: %s\n", ntp.getServerName(result.serverIndex));
         Serial.printf("Offset: %ldms\n", result.offsetMs);
         Serial.printf("Round trip: %dms\n", result.roundTripMs);
         Serial.printf("Server stratum: %d\n", result.stratum);
     } else {
-        Serial.printf("Failed to sync time: %s\n", result.error);
+        Serial.printf("Failed to sync time: %s\n", NTPClient::errorToString(result.error));
     }
     
     // Enable auto-sync every 30 minutes
@@ -97,7 +97,7 @@ void setup() {
     Serial.println("\nCurrent time:");
     Serial.printf("UTC: %s\n", NTPClient::epochToString(ntp.getEpochTime()).c_str());
     Serial.printf("Local: %s %s\n", ntp.getFormattedDateTime(), 
-                  ntp.getTimeZone().name.c_str());
+                  ntp.getTimeZone().name);
     Serial.printf("DST active: %s\n", ntp.isDST() ? "Yes" : "No");
     
     Serial.println("\nSetup complete!");
@@ -2,25 +2,15 @@
  * NTPClient Ethernet Example
  * 
  * This example demonstrates using NTPClient with Ethernet instead of WiFi.
- * It requires defining compile-time flags to use EthernetUDP.
- * 
- * Compile flags needed (in platformio.ini or build flags):
- * -DNTP_UDP_IMPLEMENTATION=\"EthernetUdp.h\"
- * -DNTP_UDP_CLASS=EthernetUDP
+ * The transport is chosen with the BasicNTPClient template argument; the
+ * older NTP_UDP_IMPLEMENTATION / NTP_UDP_CLASS build flags still work and
+ * change what the plain NTPClient alias uses.
  * 
  * Hardware:
  * - ESP32 with Ethernet (e.g., WT32-ETH01, ESP32-Ethernet-Kit)
  * - Or ESP32 with external Ethernet module (W5500, ENC28J60, etc.)
  */
 
-// IMPORTANT: These defines must come BEFORE including NTPClient.h.
-// In a real project, put these in platformio.ini build_flags (this example
-// already does so) so that the library is compiled against EthernetUDP too.
-#ifndef NTP_UDP_IMPLEMENTATION
-#define NTP_UDP_IMPLEMENTATION "EthernetUdp.h"
-#define NTP_UDP_CLASS EthernetUDP
-#endif
-
 #include <Ethernet.h>     // Arduino Ethernet library (W5100/W5500 SPI module)
 #include <EthernetUdp.h>  // EthernetUDP implementation used by NTPClient
 #include <NTPClient.h>
@@ -29,8 +19,8 @@
 byte mac[] = { 0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED };
 IPAddress ip(192, 168, 1, 177);  // Optional static IP fallback
 
-// Create NTP client instance
-NTPClient NTP;
+// Create NTP client instance over EthernetUDP, with room for 4 servers
+BasicNTPClient<EthernetUDP, 4> NTP;
 
 void setup() {
     Serial.begin(115200);
@@ -59,12 +49,12 @@ void setup() {
     
     if (result.success) {
         Serial.println("Time synchronized successfully!");
-        Serial.printf("Server: %s\n", result.serverUsed);
+        Serial.printf("Server: %s\n", NTP.getServerName(result.serverIndex));
         Serial.printf("Offset: %ldms\n", result.offsetMs);
         Serial.printf("Round trip: %dms\n", result.roundTripMs);
         Serial.printf("Server stratum: %d\n", result.stratum);
     } else {
-        Serial.printf("Failed to sync time: %s\n", result.error);
+        Serial.printf("Failed to sync time: %s\n", NTPClient::errorToString(result.error));
     }
     
     // Enable auto-sync every 30 minutes
@@ -74,7 +64,7 @@ void setup() {
     Serial.println("\nCurrent time:");
     Serial.printf("UTC: %s\n", NTPClient::epochToString(NTP.getEpochTime()).c_str());
     Serial.printf("Local: %s %s\n", NTP.getFormattedDateTime(), 
-                  NTP.getTimeZone().name.c_str());
+                  NTP.getTimeZone().name);
     Serial.printf("DST active: %s\n", NTP.isDST() ? "Yes" : "No");
     
     Serial.println("\nSetup complete!");
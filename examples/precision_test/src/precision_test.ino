@@ -69,7 +69,7 @@ void loop() {
         bool usecOk = (result.syncUsec > 0 && result.syncUsec < 1000000);
 
         Serial.printf("Sync OK: %ld.%06lu\n", result.syncTime, result.syncUsec);
-        Serial.printf("  Server: %s (stratum %d)\n", result.serverUsed, result.stratum);
+        Serial.printf("  Server: %s (stratum %d)\n", ntp.getServerName(result.serverIndex), result.stratum);
         Serial.printf("  Offset: %ldms, RTT: %dms\n", result.offsetMs, result.roundTripMs);
         Serial.printf("  syncUsec: %lu [%s]\n", result.syncUsec,
                      usecOk ? "OK - non-zero" : "WARNING - may be zero");
@@ -105,7 +105,7 @@ void loop() {
         Serial.printf("    [%s] Offset not quantized\n", notQuantized ? "PASS" : "WARN");
 
     } else {
-        Serial.printf("Sync FAILED: %s\n", result.error);
+        Serial.printf("Sync FAILED: %s\n", NTPClient::errorToString(result.error));
     }
 
     // Wait before next sync
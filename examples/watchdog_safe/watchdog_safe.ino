@@ -87,11 +87,11 @@ void setup() {
     
     if (result.success) {
         Serial.println("Time synchronized successfully!");
-        Serial.printf("Server: %s\n", result.serverUsed);
+        Serial.printf("Server: %s\n", NTP.getServerName(result.serverIndex));
         Serial.printf("Offset: %ldms\n", result.offsetMs);
         Serial.printf("Round trip: %dms\n", result.roundTripMs);
     } else {
-        Serial.printf("Failed to sync time: %s\n", result.error);
+        Serial.printf("Failed to sync time: %s\n", NTPClient::errorToString(result.error));
     }
     
     // Enable auto-sync
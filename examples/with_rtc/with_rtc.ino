@@ -102,15 +102,19 @@ void setup() {
         }
     });
     
+    // The RTC write above is a slow I2C transaction; run it (and the sync
+    // callback below) from ntp.process() instead of inside the sync, so it
+    // does not lengthen the sync or skew its timing statistics
+    ntp.setDeferredCallbacks(true);
+    
     // Set up sync event callback
-    // Note: serverUsed and error are char arrays, not String objects
     ntp.onSync([](const NTPClient::SyncResult& result) {
         if (result.success) {
-            Serial.printf("Time synced from %s\n", result.serverUsed);
+            Serial.printf("Time synced from %s\n", ntp.getServerName(result.serverIndex));
             Serial.printf("  Offset: %ldms (usec: %lu), RTT: %dms, Stratum: %d\n",
                          result.offsetMs, result.syncUsec, result.roundTripMs, result.stratum);
         } else {
-            Serial.printf("Sync failed: %s\n", result.error);
+            Serial.printf("Sync failed: %s\n", NTPClient::errorToString(result.error));
         }
     });
     
@@ -214,7 +218,7 @@ void handleSerialCommands() {
             if (ethernetConnected) {
                 auto result = ntp.syncTime();
                 if (!result.success) {
-                    Serial.printf("Sync failed: %s\n", result.error);
+                    Serial.printf("Sync failed: %s\n", NTPClient::errorToString(result.error));
                 }
             } else {
                 Serial.println("No Ethernet connection!");
@@ -229,7 +233,7 @@ void handleSerialCommands() {
                          NTPClient::epochToString(ntp.getEpochTime()).c_str());
             Serial.printf("Local Time: %s %s\n", 
                          ntp.getFormattedDateTime(),
-                         ntp.getTimeZone().name.c_str());
+                         ntp.getTimeZone().name);
             Serial.printf("DST Active: %s\n", ntp.isDST() ? "Yes" : "No");
             
             if (ntp.getLastSyncTime() > 0) {
@@ -0,0 +1,133 @@
+#ifndef NTP_CALENDAR_H
+#define NTP_CALENDAR_H
+
+// Checked here because NTPClient.h, NTPFormat.h and NTPTimeZone.h include
+// this header before any of their C++17 code
+#if __cplusplus < 201703L
+    #error "ESP32-NTPClient requires C++17: add build_unflags = -std=gnu++11 and build_flags = -std=gnu++17"
+#endif
+
+#include <stdint.h>
+#include <time.h>
+
+// Broken-down UTC (or already-offset local) time
+struct NTPCivilTime {
+    int32_t year;
+    uint8_t month;    // 1-12
+    uint8_t day;      // 1-31
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t weekday;  // 0 = Sunday
+    uint16_t yearDay; // 0-365
+};
+
+/**
+ * Proleptic Gregorian calendar in pure integer arithmetic, after Howard
+ * Hinnant's days_from_civil/civil_from_days. Independent of the TZ
+ * environment and of libc, constexpr, and 64-bit throughout, so it is
+ * valid far beyond 2038 even where time_t is 32 bits.
+ */
+class NTPCalendar {
+public:
+    static constexpr int64_t SECONDS_PER_DAY = 86400;
+
+    static constexpr bool isLeapYear(int32_t year) {
+        return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+    }
+
+    static constexpr uint8_t daysInMonth(int32_t year, uint8_t month) {
+        return month == 2 ? (isLeapYear(year) ? 29 : 28)
+                          : (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+    }
+
+    // Days since 1970-01-01 of a civil date
+    static constexpr int64_t daysFromCivil(int32_t year, uint8_t month, uint8_t day) {
+        int64_t y = (int64_t)year - (month <= 2);
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        int64_t yoe = y - era * 400;                                           // [0, 399]
+        int64_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;  // [0, 365]
+        int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                   // [0, 146096]
+        return era * 146097 + doe - 719468;
+    }
+
+    // Civil date of a day count since 1970-01-01 (time fields left zero)
+    static constexpr NTPCivilTime civilFromDays(int64_t days) {
+        int64_t z = days + 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        int64_t doe = z - era * 146097;                                        // [0, 146096]
+        int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;   // [0, 399]
+        int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);                 // [0, 365], from March 1
+        int64_t mp = (5 * doy + 2) / 153;                                      // [0, 11]
+        uint8_t month = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+        int32_t year = (int32_t)(yoe + era * 400 + (month <= 2));
+
+        NTPCivilTime civil{};
+        civil.year = year;
+        civil.month = month;
+        civil.day = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+        civil.weekday = weekdayFromDays(days);
+        civil.yearDay = (uint16_t)(days - daysFromCivil(year, 1, 1));
+        return civil;
+    }
+
+    // 0 = Sunday; 1970-01-01 was a Thursday
+    static constexpr uint8_t weekdayFromDays(int64_t days) {
+        return (uint8_t)(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+    }
+
+    // Seconds since the epoch of a civil date and time, no time zone applied
+    static constexpr int64_t toEpoch(int32_t year, uint8_t month, uint8_t day,
+                                     uint8_t hour, uint8_t minute, uint8_t second) {
+        return daysFromCivil(year, month, day) * SECONDS_PER_DAY +
+               hour * 3600L + minute * 60L + second;
+    }
+
+    // As toEpoch(), but fields may be out of range or negative and carry
+    // over the way mktime() normalizes them: month 13 is January of the
+    // next year, day 0 the last day of the previous month, minute -30
+    // half an hour before the given hour
+    static constexpr int64_t toEpochNormalized(int64_t year, int64_t month, int64_t day,
+                                               int64_t hour, int64_t minute, int64_t second) {
+        int64_t monthIndex = month - 1;
+        int64_t yearCarry = (monthIndex >= 0 ? monthIndex : monthIndex - 11) / 12;
+        return (daysFromCivil((int32_t)(year + yearCarry), (uint8_t)(monthIndex - yearCarry * 12 + 1), 1) +
+                day - 1) * SECONDS_PER_DAY +
+               hour * 3600 + minute * 60 + second;
+    }
+
+    static constexpr NTPCivilTime fromEpoch(int64_t epoch) {
+        int64_t days = epoch / SECONDS_PER_DAY;
+        int64_t secs = epoch % SECONDS_PER_DAY;
+        if (secs < 0) {
+            secs += SECONDS_PER_DAY;
+            days--;
+        }
+        NTPCivilTime civil = civilFromDays(days);
+        civil.hour = (uint8_t)(secs / 3600);
+        civil.minute = (uint8_t)(secs / 60 % 60);
+        civil.second = (uint8_t)(secs % 60);
+        return civil;
+    }
+
+    static constexpr int32_t yearOf(int64_t epoch) {
+        return fromEpoch(epoch).year;
+    }
+
+    // Fill a struct tm for strftime(); tm_isdst is left 0 as the time is
+    // taken as-is (UTC or already shifted to local time)
+    static void toTm(int64_t epoch, struct tm& out) {
+        NTPCivilTime civil = fromEpoch(epoch);
+        out = tm();
+        out.tm_year = civil.year - 1900;
+        out.tm_mon = civil.month - 1;
+        out.tm_mday = civil.day;
+        out.tm_hour = civil.hour;
+        out.tm_min = civil.minute;
+        out.tm_sec = civil.second;
+        out.tm_wday = civil.weekday;
+        out.tm_yday = civil.yearDay;
+    }
+};
+
+#endif // NTP_CALENDAR_H
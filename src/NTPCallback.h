@@ -0,0 +1,209 @@
+#ifndef NTP_CALLBACK_H
+#define NTP_CALLBACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bytes of inline storage per callback. Enough for a function pointer, a
+// lambda capturing a few pointers, or a std::function. Larger callables are
+// rejected at compile time instead of being moved to the heap.
+#ifndef NTP_CALLBACK_STORAGE
+#define NTP_CALLBACK_STORAGE (4 * sizeof(void*))
+#endif
+
+template <typename Signature, size_t Capacity = NTP_CALLBACK_STORAGE>
+class NTPInplaceFunction;
+
+/**
+ * Type-erased callable with fixed inline storage. Accepts function pointers
+ * and lambdas like std::function, but never allocates: a callable that does
+ * not fit in Capacity bytes is a compile error.
+ */
+template <typename R, typename... Args, size_t Capacity>
+class NTPInplaceFunction<R(Args...), Capacity> {
+public:
+    NTPInplaceFunction() noexcept : _invoke(nullptr), _manage(nullptr) {}
+    NTPInplaceFunction(std::nullptr_t) noexcept : NTPInplaceFunction() {}
+
+    template <typename F,
+              typename = typename std::enable_if<
+                  !std::is_same<typename std::decay<F>::type, NTPInplaceFunction>::value>::type>
+    NTPInplaceFunction(F&& callable) : NTPInplaceFunction() {
+        using Stored = typename std::decay<F>::type;
+        static_assert(sizeof(Stored) <= Capacity,
+                      "Callback too large for inline storage; capture less or raise NTP_CALLBACK_STORAGE");
+        static_assert(alignof(Stored) <= alignof(Storage), "Callback over-aligned for inline storage");
+
+        if constexpr (std::is_pointer<typename std::remove_reference<F>::type>::value) {
+            if (callable == nullptr) return;  // Null function pointer stays empty
+        }
+        new (&_storage) Stored(std::forward<F>(callable));
+        _invoke = [](void* target, Args... args) -> R {
+            return (*static_cast<Stored*>(target))(std::forward<Args>(args)...);
+        };
+        _manage = [](Operation op, void* dst, void* src) {
+            switch (op) {
+                case COPY:    new (dst) Stored(*static_cast<const Stored*>(src)); break;
+                case MOVE:    new (dst) Stored(std::move(*static_cast<Stored*>(src)));
+                              static_cast<Stored*>(src)->~Stored(); break;
+                case DESTROY: static_cast<Stored*>(dst)->~Stored(); break;
+            }
+        };
+    }
+
+    NTPInplaceFunction(const NTPInplaceFunction& other) : _invoke(other._invoke), _manage(other._manage) {
+        if (_manage) _manage(COPY, &_storage, &other._storage);
+    }
+
+    NTPInplaceFunction(NTPInplaceFunction&& other) noexcept : _invoke(other._invoke), _manage(other._manage) {
+        if (_manage) _manage(MOVE, &_storage, &other._storage);
+        other._invoke = nullptr;
+        other._manage = nullptr;
+    }
+
+    ~NTPInplaceFunction() { reset(); }
+
+    NTPInplaceFunction& operator=(const NTPInplaceFunction& other) {
+        if (this != &other) {
+            reset();
+            if (other._manage) other._manage(COPY, &_storage, &other._storage);
+            _invoke = other._invoke;
+            _manage = other._manage;
+        }
+        return *this;
+    }
+
+    NTPInplaceFunction& operator=(NTPInplaceFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other._manage) other._manage(MOVE, &_storage, &other._storage);
+            _invoke = other._invoke;
+            _manage = other._manage;
+            other._invoke = nullptr;
+            other._manage = nullptr;
+        }
+        return *this;
+    }
+
+    NTPInplaceFunction& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    void reset() noexcept {
+        if (_manage) _manage(DESTROY, &_storage, nullptr);
+        _invoke = nullptr;
+        _manage = nullptr;
+    }
+
+    explicit operator bool() const noexcept { return _invoke != nullptr; }
+
+    R operator()(Args... args) const {
+        return _invoke(&_storage, std::forward<Args>(args)...);
+    }
+
+private:
+    enum Operation : uint8_t { COPY, MOVE, DESTROY };
+    struct alignas(alignof(max_align_t)) Storage {
+        unsigned char bytes[Capacity];
+    };
+
+    mutable Storage _storage;
+    R (*_invoke)(void*, Args...);
+    void (*_manage)(Operation, void*, void*);
+};
+
+/**
+ * Fixed set of subscribers to one event. Slot 0 belongs to the primary
+ * subscriber (the classic single-callback setter, which replaces it);
+ * add() hands out the remaining slots and returns an id for remove().
+ */
+template <typename Signature, uint8_t MaxListeners>
+class NTPCallbackList {
+public:
+    using Function = NTPInplaceFunction<Signature>;
+    static_assert(MaxListeners >= 1, "A callback list needs at least the primary slot");
+
+    void setPrimary(Function callback) { _slots[0] = std::move(callback); }
+
+    // Returns the listener id, or -1 when all slots are taken
+    int8_t add(Function callback) {
+        if (!callback) return -1;
+        for (uint8_t i = 1; i < MaxListeners; i++) {
+            if (!_slots[i]) {
+                _slots[i] = std::move(callback);
+                return (int8_t)i;
+            }
+        }
+        return -1;
+    }
+
+    bool remove(int8_t id) {
+        if (id < 1 || id >= (int8_t)MaxListeners || !_slots[id]) return false;
+        _slots[id] = nullptr;
+        return true;
+    }
+
+    template <typename... Args>
+    void operator()(Args&&... args) const {
+        for (uint8_t i = 0; i < MaxListeners; i++) {
+            if (_slots[i]) {
+                _slots[i](args...);
+            }
+        }
+    }
+
+private:
+    Function _slots[MaxListeners];
+};
+
+/**
+ * Fixed-size single-producer/single-consumer ring used to defer callbacks.
+ * One task may push() while another pop()s without locking; indices are
+ * free-running, so Capacity must be a power of two.
+ */
+template <typename T, uint8_t Capacity>
+class NTPEventQueue {
+public:
+    static_assert(Capacity > 0 && Capacity <= 128 && (Capacity & (Capacity - 1)) == 0,
+                  "Event queue capacity must be a power of two up to 128");
+
+    NTPEventQueue() : _head(0), _tail(0) {}
+
+    // Producer side. Returns false (and drops the item) when full.
+    bool push(const T& item) {
+        uint8_t head = _head.load(std::memory_order_relaxed);
+        if ((uint8_t)(head - _tail.load(std::memory_order_acquire)) >= Capacity) {
+            return false;
+        }
+        _items[head & (Capacity - 1)] = item;
+        _head.store((uint8_t)(head + 1), std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        uint8_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail == _head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[tail & (Capacity - 1)];
+        _tail.store((uint8_t)(tail + 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _tail.load(std::memory_order_acquire) == _head.load(std::memory_order_acquire);
+    }
+
+private:
+    T _items[Capacity];
+    std::atomic<uint8_t> _head;
+    std::atomic<uint8_t> _tail;
+};
+
+#endif // NTP_CALLBACK_H
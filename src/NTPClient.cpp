@@ -1,364 +1,256 @@
 #include "NTPClient.h"
 #include <sys/time.h>
-#include <lwip/def.h>  // htonl/ntohl byte-order helpers
 
 // Default NTP servers
-const char* NTPClient::DEFAULT_NTP_SERVERS[] = {
+const char* NTPClientBase::DEFAULT_NTP_SERVERS[] = {
     "pool.ntp.org",
     "time.nist.gov",
     "time.google.com",
     "time.cloudflare.com"
 };
-const uint8_t NTPClient::DEFAULT_SERVER_COUNT = 4;
+const uint8_t NTPClientBase::DEFAULT_SERVER_COUNT = 4;
 
 // No global instance - users must create their own
 
-NTPClient::NTPClient() 
+NTPClientBase::NTPClientBase() 
     : _localPort(8888),
+      _zone(),
+      _lookupZone(),
       _initialized(false),
       _autoSyncEnabled(false),
       _autoSyncInterval(3600),
+      _syncTimeout(DEFAULT_SYNC_TIMEOUT_MS),
       _lastSyncTime(0),
       _lastProcessTime(0),
       _lastOffset(0),
       _syncCount(0),
       _syncFailures(0),
       _averageSyncTime(0),
-      _totalSyncTime(0) {
-    
-    // Initialize with UTC
-    _timezone = getTimeZoneUTC();
+      _totalSyncTime(0),
+      _firstSyncSpread(0),
+      _jitterPercent(0),
+      _jitterSeed(0),
+      _jitterState(0),
+      _hedgingEnabled(false),
+      _droppedEvents(0),
+      _deferCallbacks(false),
+      _dispatchFromProcess(true) {
 }
 
-void NTPClient::begin(uint16_t localPort) {
-    _localPort = localPort;
-    _udp.begin(_localPort);
-    _initialized = true;
-    
-    NTP_LOG_I("NTP Client initialized on port %d", _localPort);
-    
-    if (_servers.empty()) {
-        NTP_LOG_W("No NTP servers configured. Add servers or use beginWithDefaults()");
-    }
+void NTPClientBase::setHedging(bool enable) {
+    _hedgingEnabled = enable;
+    NTP_LOG_I("Hedged requests %s", enable ? "enabled" : "disabled");
 }
 
-void NTPClient::beginWithDefaults(uint16_t localPort) {
-    // Add default servers before initialization
-    if (_servers.empty()) {
-        NTP_LOG_I("Adding default NTP servers");
-        for (uint8_t i = 0; i < DEFAULT_SERVER_COUNT; i++) {
-            (void)addServer(DEFAULT_NTP_SERVERS[i]);
-        }
-    }
+int32_t NTPClientBase::offsetFromSystemMs(time_t ntpTime, uint32_t ntpUsec) const {
+    // Calculate offset with MICROSECOND precision using gettimeofday()
+    struct timeval currentTv;
+    gettimeofday(&currentTv, nullptr);
+
+    // Calculate offset in microseconds, then convert to milliseconds
+    int64_t ntpEpochUs = (int64_t)ntpTime * 1000000LL + ntpUsec;
+    int64_t sysEpochUs = (int64_t)currentTv.tv_sec * 1000000LL + currentTv.tv_usec;
+    int64_t offsetUs = ntpEpochUs - sysEpochUs;
+    int32_t offset = (int32_t)(offsetUs / 1000LL);  // Convert to milliseconds
+
+    NTP_LOG_D("Offset calculation: NTP=%ld.%06lu, Sys=%ld.%06ld, offset=%ldms",
+              ntpTime, ntpUsec, currentTv.tv_sec, currentTv.tv_usec, offset);
+    return offset;
+}
+
+void NTPClientBase::setSyncJitter(uint32_t firstSyncSpreadSeconds, uint8_t intervalJitterPercent) {
+    _firstSyncSpread = firstSyncSpreadSeconds;
+    _jitterPercent = min(intervalJitterPercent, MAX_JITTER_PERCENT);
     
-    // Initialize normally
-    begin(localPort);
+    NTP_LOG_I("Sync jitter: first sync within %lus, interval +/-%d%%",
+              _firstSyncSpread, _jitterPercent);
 }
 
-void NTPClient::end() {
-    _udp.stop();
-    _initialized = false;
-    NTP_LOG_I("NTP Client stopped");
+void NTPClientBase::setJitterSeed(uint32_t seed) {
+    _jitterSeed = seed;
+    _jitterState = 0;  // Re-derive the random stream from the new seed
 }
 
-bool NTPClient::addServer(const String& hostname, uint16_t port) {
-    // Allow adding servers before begin() for pre-configuration
-    if (_servers.size() >= MAX_SERVERS) {
-        NTP_LOG_E("Maximum number of servers (%d) reached", MAX_SERVERS);
+void NTPClientBase::setTimeZone(const TimeZoneConfig& config) {
+    setTimeZone(NTPTimeZone(config));
+}
+
+void NTPClientBase::setTimeZone(const NTPTimeZone& zone) {
+    _zone = zone;
+    NTP_LOG_I("Time zone set to %s (UTC%+d)", 
+              zone.name(), zone.config().offsetMinutes / 60);
+}
+
+bool NTPClientBase::setTimeZone(const char* posixTZ) {
+    TimeZoneConfig config;
+    if (!parseTimeZone(posixTZ, config)) {
+        NTP_LOG_E("Invalid POSIX TZ string: %s", posixTZ ? posixTZ : "(null)");
         return false;
     }
-    
-    // Check if already exists
-    for (const auto& server : _servers) {
-        if (server.hostname == hostname && server.port == port) {
-            NTP_LOG_D("Server %s:%d already exists, skipping", hostname.c_str(), port);
-            return true;  // Not an error, server is available
-        }
-    }
-    
-    NTPServer server;
-    server.hostname = hostname;
-    server.port = port;
-    server.lastSuccessTime = 0;
-    server.failureCount = 0;
-    server.averageOffset = 0;
-    server.averageRTT = 0;
-    server.reachable = true;
-    server.stratum = 255;
-    
-    _servers.push_back(server);
-    
-    NTP_LOG_I("Added NTP server %s:%d", hostname.c_str(), port);
+    setTimeZone(config);
     return true;
 }
 
-bool NTPClient::removeServer(const String& hostname) {
-    auto it = std::remove_if(_servers.begin(), _servers.end(),
-                            [&hostname](const NTPServer& s) { return s.hostname == hostname; });
-    
-    if (it != _servers.end()) {
-        _servers.erase(it, _servers.end());
-        NTP_LOG_I("Removed NTP server %s", hostname.c_str());
-        return true;
+bool NTPClientBase::setTimeZone(NTPZoneId zone) {
+    if (zone >= NTP_ZONE_COUNT) {
+        NTP_LOG_E("Unknown time zone id %d", zone);
+        return false;
     }
-    
-    NTP_LOG_W("Server %s not found", hostname.c_str());
-    return false;
+    setTimeZone(NTPTimeZone(zone));
+    return true;
 }
 
-void NTPClient::clearServers() {
-    _servers.clear();
-    NTP_LOG_I("Cleared all NTP servers");
+bool NTPClientBase::lookupZone(NTPZoneId zone, time_t utc, ZoneInterval& out) {
+    if (zone >= NTP_ZONE_COUNT) return false;
+    NTPTimeZone(zone).lookup(utc, out);
+    return true;
 }
 
-NTPClient::NTPServer* NTPClient::getBestServer() {
-    NTPServer* best = nullptr;
-    uint32_t bestScore = UINT32_MAX;
-    
-    for (auto& server : _servers) {
-        if (!server.reachable) continue;
-        
-        // Score based on stratum, failures, and average RTT
-        uint32_t score = (server.stratum * 1000) + 
-                        (server.failureCount * 100) + 
-                        server.averageRTT;
-        
-        if (score < bestScore) {
-            bestScore = score;
-            best = &server;
-        }
-    }
-    
-    return best;
+bool NTPClientBase::isDST() const {
+    return isDST(time(nullptr));
 }
 
-NTPClient::SyncResult NTPClient::syncTime(uint32_t timeoutMs) {
-    static SyncResult result; // Use static to avoid stack corruption on return
-    result = SyncResult();    // Clear it
-    
-    if (!_initialized) {
-        strncpy(result.error, "NTP client not initialized", sizeof(result.error) - 1);
-        result.error[sizeof(result.error) - 1] = '\0';
-        return result;
-    }
-    
-    // Try best server first
-    NTPServer* bestServer = getBestServer();
-    if (bestServer) {
-        result = syncTimeFromServer(bestServer->hostname, timeoutMs);
-        if (result.success) {
-            return result;
-        }
-    }
-    
-    // Try all servers in order
-    for (auto& server : _servers) {
-        if (!server.reachable) continue;
-        
-        result = syncTimeFromServer(server.hostname, timeoutMs);
-        if (result.success) {
-            return result;
-        }
-    }
-    
-    _syncFailures++;
-    strncpy(result.error, "Failed to sync with any server", sizeof(result.error) - 1);
-    result.error[sizeof(result.error) - 1] = '\0';
-    return result;
-}
-
-NTPClient::SyncResult NTPClient::syncTimeFromServer(const String& hostname, uint32_t timeoutMs) {
-    static SyncResult result; // Use static to avoid stack corruption on return
-    result = SyncResult();    // Clear it
-    result.success = false;
-    strncpy(result.serverUsed, hostname.c_str(), sizeof(result.serverUsed) - 1);
-    result.serverUsed[sizeof(result.serverUsed) - 1] = '\0';
-    result.syncTime = 0;
-    
-    uint32_t startTime = millis();
-    
-    NTP_LOG_D("Attempting sync with %s", hostname.c_str());
-    
-    // Find server in list
-    NTPServer* serverInfo = nullptr;
-    for (auto& server : _servers) {
-        if (server.hostname == hostname) {
-            serverInfo = &server;
-            break;
-        }
-    }
-    
-    // Send NTP request
-    if (!sendNTPPacket(hostname)) {
-        strncpy(result.error, "Failed to send NTP packet", sizeof(result.error) - 1);
-        result.error[sizeof(result.error) - 1] = '\0';
-        NTP_LOG_SYNC_FAILED(hostname.c_str(), result.error);
-        if (serverInfo) {
-            updateServerStats(*serverInfo, false, 0, 0);
-        }
-        return result;
-    }
-    
-    // Receive response
-    NTPPacket packet;
-    if (!receiveNTPPacket(packet, timeoutMs)) {
-        strncpy(result.error, "Timeout waiting for NTP response", sizeof(result.error) - 1);
-        result.error[sizeof(result.error) - 1] = '\0';
-        NTP_LOG_SYNC_FAILED(hostname.c_str(), result.error);
-        if (serverInfo) {
-            updateServerStats(*serverInfo, false, 0, 0);
-        }
-        return result;
-    }
-    
-    // Parse response - now returns BOTH seconds and microseconds
-    uint16_t rtt = millis() - startTime;
-    uint32_t ntpUsec = 0;
-    time_t ntpTime = parseNTPPacket(packet, rtt, ntpUsec);
-
-    if (ntpTime == 0) {
-        strncpy(result.error, "Invalid NTP packet received", sizeof(result.error) - 1);
-        result.error[sizeof(result.error) - 1] = '\0';
-        NTP_LOG_SYNC_FAILED(hostname.c_str(), result.error);
-        if (serverInfo) {
-            updateServerStats(*serverInfo, false, 0, 0);
-        }
-        return result;
-    }
-
-    // Calculate offset with MICROSECOND precision using gettimeofday()
-    struct timeval currentTv;
-    gettimeofday(&currentTv, nullptr);
+bool NTPClientBase::isDST(time_t timestamp) const {
+    return _zone.isDST(timestamp);
+}
 
-    // Calculate offset in microseconds, then convert to milliseconds
-    int64_t ntpEpochUs = (int64_t)ntpTime * 1000000LL + ntpUsec;
-    int64_t sysEpochUs = (int64_t)currentTv.tv_sec * 1000000LL + currentTv.tv_usec;
-    int64_t offsetUs = ntpEpochUs - sysEpochUs;
-    int32_t offset = (int32_t)(offsetUs / 1000LL);  // Convert to milliseconds
+time_t NTPClientBase::getEpochTime() const {
+    return time(nullptr);
+}
 
-    NTP_LOG_D("Offset calculation: NTP=%ld.%06lu, Sys=%ld.%06ld, offset=%ldms",
-              ntpTime, ntpUsec, currentTv.tv_sec, currentTv.tv_usec, offset);
+time_t NTPClientBase::getLocalTime() const {
+    return _zone.toLocal(time(nullptr));
+}
 
-    // Apply time with microsecond precision
-    applyTimeOffset(ntpTime, ntpUsec);
-
-    // Update result
-    result.success = true;
-    result.offsetMs = offset;
-    result.syncUsec = ntpUsec;
-    result.roundTripMs = rtt;
-    result.stratum = packet.stratum;
-    NTP_LOG_D("Setting result.syncTime to ntpTime=%ld.%06lu", ntpTime, ntpUsec);
-    result.syncTime = ntpTime;
-    NTP_LOG_D("Verify: result.syncTime=%ld, syncUsec=%lu", result.syncTime, result.syncUsec);
-    
-    // Update statistics
-    _syncCount++;
-    _lastSyncTime = ntpTime;
-    _lastOffset = offset;
-    
-    uint32_t syncTime = millis() - startTime;
-    _totalSyncTime += syncTime;
-    _averageSyncTime = (float)_totalSyncTime / _syncCount;
-    
-    if (serverInfo) {
-        updateServerStats(*serverInfo, true, offset, rtt);
-        serverInfo->stratum = packet.stratum;
+time_t NTPClientBase::getLocalTime(NTPZoneId zone) const {
+    if (zone == _zone.id()) {
+        return getLocalTime();
     }
-    
-    NTP_LOG_SYNC_SUCCESS(hostname.c_str(), offset);
-    NTP_LOG_SERVER_STATS(hostname.c_str(), rtt, offset);
-    
-    // Trigger callbacks
-    if (_syncCallback) {
-        _syncCallback(result);
+    if (zone != _lookupZone.id()) {
+        _lookupZone = NTPTimeZone(zone);
     }
+    return _lookupZone.toLocal(time(nullptr));
+}
+
+size_t NTPClientBase::formatLocal(time_t utc, const NTPTimeZone& zone, char* buffer, size_t length,
+                                  const char* format) {
+    if (buffer == nullptr || length == 0) return 0;
     
-    if (_rtcCallback) {
-        _rtcCallback(ntpTime);
+    struct tm timeinfo;
+    NTPCalendar::toTm(zone.toLocal(utc), timeinfo);
+    size_t written = strftime(buffer, length, format, &timeinfo);
+    if (written == 0) {
+        buffer[0] = '\0';
     }
+    return written;
+}
+
+size_t NTPClientBase::formatBatch(const time_t* utc, size_t count, const NTPTimeZone& zone,
+                                  NTPTimeFormat format, char* buffer, size_t length, char separator) {
+    if (buffer == nullptr || length == 0) return 0;
     
-    return result;
+    NTPFormatMemo memo;
+    size_t used = 0;
+    size_t done = 0;
+    for (; done < count; done++) {
+        if (done > 0) {
+            if (used + 1 >= length) break;
+            buffer[used++] = separator;
+        }
+        size_t written = memo.format(utc[done], 0, zone.offsetMinutes(utc[done]), format,
+                                     buffer + used, length - used);
+        if (written == 0) {
+            if (done > 0) used--;  // Drop the dangling separator
+            break;
+        }
+        used += written;
+    }
+    buffer[used] = '\0';
+    return done;
 }
 
-bool NTPClient::forceSync() {
-    NTP_LOG_I("Forcing time sync");
-    SyncResult result = syncTime();
-    return result.success;
+size_t NTPClientBase::formatRFC3339(char* buffer, size_t length, uint8_t fractionDigits) const {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    return NTPFormat::rfc3339(now.tv_sec, (uint32_t)now.tv_usec * 1000,
+                              offsetMinutesAt(now.tv_sec), fractionDigits, buffer, length);
 }
 
-void NTPClient::setAutoSync(bool enable, uint32_t intervalSeconds) {
-    _autoSyncEnabled = enable;
-    _autoSyncInterval = max(intervalSeconds, MIN_SYNC_INTERVAL);
-    
-    NTP_LOG_I("Auto-sync %s (interval: %d seconds)", 
-              enable ? "enabled" : "disabled", _autoSyncInterval);
+// Uncached: leaves _zone's lookup cache alone so concurrent callers do not race
+int16_t NTPClientBase::offsetMinutesAt(time_t utc) const {
+    ZoneInterval interval;
+    _zone.lookup(utc, interval);
+    return interval.offsetMinutes;
 }
 
-time_t NTPClient::getNextSyncTime() const {
-    if (!_autoSyncEnabled || _lastSyncTime == 0) {
+size_t NTPClientBase::formatTime(char* buffer, size_t length, NTPTimeFormat format) const {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    int16_t offsetMinutes = offsetMinutesAt(now.tv_sec);
+    
+    if (now.tv_sec + offsetMinutes * 60L < 86400) {  // Not synced
+        if (buffer != nullptr && length > 0) buffer[0] = '\0';
         return 0;
     }
-    return _lastSyncTime + _autoSyncInterval;
+    return NTPFormat::format(now.tv_sec, (uint32_t)now.tv_usec * 1000, offsetMinutes, format,
+                             buffer, length);
 }
 
-void NTPClient::setTimeZone(const TimeZoneConfig& config) {
-    _timezone = config;
-    NTP_LOG_I("Time zone set to %s (UTC%+d)", 
-              config.name.c_str(), config.offsetMinutes / 60);
+size_t NTPClientBase::formatTime(char* buffer, size_t length, const char* format) const {
+    if (buffer == nullptr || length == 0) return 0;
+    buffer[0] = '\0';
+    
+    time_t now = time(nullptr);
+    time_t local = now + offsetMinutesAt(now) * 60L;
+    if (local < 86400) return 0;  // Not synced
+    
+    struct tm timeinfo;
+    NTPCalendar::toTm(local, timeinfo);
+    size_t written = strftime(buffer, length, format, &timeinfo);
+    if (written == 0) {
+        buffer[0] = '\0';
+    }
+    return written;
 }
 
-bool NTPClient::isDST() const {
-    return isDST(time(nullptr));
+NTPClientBase::FormattedTime NTPClientBase::formatTime(NTPTimeFormat format) const {
+    FormattedTime text;
+    text[0] = '\0';
+    formatTime(text.data(), text.size(), format);
+    return text;
 }
 
-bool NTPClient::isDST(time_t timestamp) const {
-    if (!_timezone.useDST) return false;
-    
-    struct tm timeinfo;
-    gmtime_r(&timestamp, &timeinfo);
-    
-    int year = timeinfo.tm_year + 1900;
-    
-    time_t dstStart = getDSTTransition(year, _timezone.dstStartMonth, 
-                                      _timezone.dstStartWeek, 
-                                      _timezone.dstStartDayOfWeek,
-                                      _timezone.dstStartHour);
-    
-    time_t dstEnd = getDSTTransition(year, _timezone.dstEndMonth,
-                                    _timezone.dstEndWeek,
-                                    _timezone.dstEndDayOfWeek,
-                                    _timezone.dstEndHour);
-    
-    if (dstStart < dstEnd) {
-        // Northern hemisphere
-        return timestamp >= dstStart && timestamp < dstEnd;
-    } else {
-        // Southern hemisphere
-        return timestamp >= dstStart || timestamp < dstEnd;
-    }
+size_t NTPClientBase::formatRFC3339(time_t utc, uint32_t nanos, const NTPTimeZone& zone,
+                                    char* buffer, size_t length, uint8_t fractionDigits) {
+    return NTPFormat::rfc3339(utc, nanos, zone.offsetMinutes(utc), fractionDigits, buffer, length);
 }
 
-time_t NTPClient::getEpochTime() const {
-    return time(nullptr);
+const char* NTPClientBase::getFormattedTime() const {
+    return getFormattedTime(NTPTimeFormat::TIME);
 }
 
-time_t NTPClient::getLocalTime() const {
-    time_t utc = time(nullptr);
-    int16_t offset = _timezone.offsetMinutes;
+const char* NTPClientBase::getFormattedTime(NTPTimeFormat format) const {
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    int16_t offsetMinutes = _zone.offsetMinutes(now.tv_sec);
     
-    if (isDST(utc)) {
-        offset += _timezone.dstOffsetMinutes;
+    // Check for uninitialized time (1970 epoch)
+    if (now.tv_sec + offsetMinutes * 60L < 86400) {
+        strncpy(_formattedBuffer, "Not Synced", sizeof(_formattedBuffer) - 1);
+        _formattedBuffer[sizeof(_formattedBuffer) - 1] = '\0';
+        return _formattedBuffer;
     }
     
-    return utc + (offset * 60);
-}
-
-const char* NTPClient::getFormattedTime() const {
-    return getFormattedTime("%H:%M:%S");
+    if (_formatMemo.format(now.tv_sec, (uint32_t)now.tv_usec * 1000, offsetMinutes, format,
+                           _formattedBuffer, sizeof(_formattedBuffer)) == 0) {
+        strncpy(_formattedBuffer, "Format Error", sizeof(_formattedBuffer) - 1);
+        _formattedBuffer[sizeof(_formattedBuffer) - 1] = '\0';
+    }
+    
+    return _formattedBuffer;
 }
 
-const char* NTPClient::getFormattedTime(const char* format) const {
+const char* NTPClientBase::getFormattedTime(const char* format) const {
     time_t local = getLocalTime();
     
     // Check for uninitialized time (1970 epoch)
@@ -368,12 +260,9 @@ const char* NTPClient::getFormattedTime(const char* format) const {
         return _formattedBuffer;
     }
     
+    // Already shifted to local time, so broken down as-is
     struct tm timeinfo;
-    if (!localtime_r(&local, &timeinfo)) {
-        strncpy(_formattedBuffer, "Invalid Time", sizeof(_formattedBuffer) - 1);
-        _formattedBuffer[sizeof(_formattedBuffer) - 1] = '\0';
-        return _formattedBuffer;
-    }
+    NTPCalendar::toTm(local, timeinfo);
     
     size_t result = strftime(_formattedBuffer, sizeof(_formattedBuffer), format, &timeinfo);
     if (result == 0) {
@@ -384,15 +273,15 @@ const char* NTPClient::getFormattedTime(const char* format) const {
     return _formattedBuffer;
 }
 
-const char* NTPClient::getFormattedDate() const {
-    return getFormattedTime("%Y-%m-%d");
+const char* NTPClientBase::getFormattedDate() const {
+    return getFormattedTime(NTPTimeFormat::DATE);
 }
 
-const char* NTPClient::getFormattedDateTime() const {
-    return getFormattedTime("%Y-%m-%d %H:%M:%S");
+const char* NTPClientBase::getFormattedDateTime() const {
+    return getFormattedTime(NTPTimeFormat::DATE_TIME);
 }
 
-void NTPClient::setEpochTime(time_t epoch) {
+void NTPClientBase::setEpochTime(time_t epoch) {
     struct timeval tv;
     tv.tv_sec = epoch;
     tv.tv_usec = 0;
@@ -401,148 +290,73 @@ void NTPClient::setEpochTime(time_t epoch) {
     String timeStr = epochToString(epoch);
     NTP_LOG_I("Time set manually to %s", timeStr.c_str());
     
-    if (_timeChangeCallback) {
-        _timeChangeCallback(time(nullptr), epoch);
-    }
+    notifyTimeChange(time(nullptr), epoch);
 }
 
-void NTPClient::adjustTime(int32_t offsetSeconds) {
+void NTPClientBase::adjustTime(int32_t offsetSeconds) {
     time_t current = time(nullptr);
     setEpochTime(current + offsetSeconds);
 }
 
-void NTPClient::syncToRTC() {
+void NTPClientBase::syncToRTC() {
     if (_rtcCallback) {
         _rtcCallback(time(nullptr));
         NTP_LOG_I("Time synced to RTC");
     }
 }
 
-void NTPClient::printDiagnostics() {
-    NTP_LOG_I("=== NTP Client Diagnostics ===");
-    NTP_LOG_I("Status: %s", _initialized ? "Initialized" : "Not initialized");
-    NTP_LOG_I("Auto-sync: %s (interval: %ds)", 
-              _autoSyncEnabled ? "ON" : "OFF", _autoSyncInterval);
-    NTP_LOG_I("Current time: %s", getFormattedDateTime());
-    NTP_LOG_I("Time zone: %s (UTC%+d)", 
-              _timezone.name.c_str(), _timezone.offsetMinutes / 60);
-    NTP_LOG_I("DST: %s", isDST() ? "Active" : "Inactive");
-    String lastSyncStr = _lastSyncTime ? epochToString(_lastSyncTime) : "Never";
-    NTP_LOG_I("Last sync: %s", lastSyncStr.c_str());
-    NTP_LOG_I("Last offset: %ldms", _lastOffset);
-    NTP_LOG_I("Sync count: %d (failures: %d)", _syncCount, _syncFailures);
-    NTP_LOG_I("Average sync time: %.1fms", _averageSyncTime);
-    
-    NTP_LOG_I("\nServers (%d):", _servers.size());
-    for (const auto& server : _servers) {
-        NTP_LOG_I("  %s:%d - Stratum %d, RTT %dms, Offset %ldms, %s",
-                  server.hostname.c_str(), server.port,
-                  server.stratum, server.averageRTT, server.averageOffset,
-                  server.reachable ? "OK" : "UNREACHABLE");
-    }
-    
-    NTP_LOG_I("==============================");
-}
-
-void NTPClient::resetStatistics() {
-    _syncCount = 0;
-    _syncFailures = 0;
-    _averageSyncTime = 0;
-    _totalSyncTime = 0;
-    
-    for (auto& server : _servers) {
-        server.failureCount = 0;
-        server.averageOffset = 0;
-        server.averageRTT = 0;
-        server.reachable = true;
-    }
+uint32_t NTPClientBase::jitteredInterval(uint32_t intervalSeconds) {
+    if (_jitterPercent == 0) return intervalSeconds;
     
-    NTP_LOG_I("Statistics reset");
-}
-
-void NTPClient::process() {
-    if (!_initialized || !_autoSyncEnabled) return;
-    
-    time_t now = time(nullptr);
+    uint32_t span = (uint32_t)(((uint64_t)intervalSeconds * _jitterPercent) / 100);
+    if (span == 0) return intervalSeconds;
     
-    // Check if it's time to sync
-    if (_lastSyncTime == 0 || (now - _lastSyncTime) >= _autoSyncInterval) {
-        NTP_LOG_D("Auto-sync triggered");
-        (void)syncTime();
-    }
+    return intervalSeconds - span + (nextJitterRandom() % (2 * span + 1));
 }
 
-bool NTPClient::sendNTPPacket(const String& address) {
-    NTPPacket packet;
-    memset(&packet, 0, sizeof(packet));
-    
-    // Initialize values needed for NTP request
-    // li = 0, vn = 3, mode = 3 (client)
-    packet.li_vn_mode = 0b00100011;
-    
-    // Current time as originate timestamp
-    time_t now = time(nullptr);
-    uint32_t origTime = now + NTP_TIMESTAMP_DELTA;
-    packet.origTm_s = htonl(origTime);
-    
-    NTP_LOG_I("Sending NTP request to %s", address.c_str());
-    NTP_LOG_I("Origin timestamp: %lu (0x%08X), current system time: %ld", 
-              origTime, origTime, now);
-    
-    // Send packet
-    if (_udp.beginPacket(address.c_str(), DEFAULT_NTP_PORT) != 1) {
-        NTP_LOG_E("Failed to begin UDP packet to %s", address.c_str());
-        return false;
-    }
-    
-    _udp.write((uint8_t*)&packet, sizeof(packet));
-    
-    if (_udp.endPacket() != 1) {
-        NTP_LOG_E("Failed to send UDP packet to %s", address.c_str());
-        return false;
-    }
-    
-    NTP_LOG_V("NTP packet sent to %s", address.c_str());
-    return true;
-}
-
-bool NTPClient::receiveNTPPacket(NTPPacket& packet, uint32_t timeoutMs) {
-    uint32_t startTime = millis();
-    
-    while ((millis() - startTime) < timeoutMs) {
-        int packetSize = _udp.parsePacket();
-        
-        if (packetSize >= sizeof(NTPPacket)) {
-            _udp.read((uint8_t*)&packet, sizeof(packet));
-            NTP_LOG_V("NTP packet received (size: %d)", packetSize);
-            
-            // Debug: Log raw transmit timestamp bytes
-            #ifdef NTP_DEBUG
-            uint8_t* txBytes = (uint8_t*)&packet.txTm_s;
-            NTP_LOG_V("Raw txTm_s bytes: %02X %02X %02X %02X", 
-                      txBytes[0], txBytes[1], txBytes[2], txBytes[3]);
-            #endif
-            
-            return true;
-        }
-        
-        // Allow caller to yield control (e.g., for watchdog feeding)
-        if (_yieldCallback) {
-            _yieldCallback();
+uint32_t NTPClientBase::nextJitterRandom() {
+    if (_jitterState == 0) {
+        uint32_t seed = _jitterSeed;
+        if (seed == 0) {
+            // Default phase comes from the factory MAC, unique per device
+            uint64_t mac = ESP.getEfuseMac();
+            seed = (uint32_t)mac ^ (uint32_t)(mac >> 32);
         }
         
-        // Small delay to prevent tight loop
-        delay(1);
-        yield();
+        // Mix the seed so neighbouring MACs land on unrelated phases
+        seed ^= seed >> 16;
+        seed *= 0x7FEB352DUL;
+        seed ^= seed >> 15;
+        seed *= 0x846CA68BUL;
+        seed ^= seed >> 16;
+        _jitterState = seed ? seed : 0x9E3779B9UL;
+    }
+    
+    // xorshift32: tiny, allocation-free and good enough for spreading load
+    _jitterState ^= _jitterState << 13;
+    _jitterState ^= _jitterState >> 17;
+    _jitterState ^= _jitterState << 5;
+    return _jitterState;
+}
+
+time_t NTPClientBase::parseNTPPacket(const NTPPacketView& packet, uint16_t& rtt, uint32_t& usecOut,
+                                 uint32_t& kissOut) {
+    kissOut = 0;
+    
+    // Stratum 0 is a Kiss-o'-Death: refId carries a 4-character code and
+    // the timestamps are meaningless
+    if (packet.stratum() == 0) {
+        kissOut = packet.referenceId();
+        char code[5];
+        kissCodeToString(kissOut, code);
+        NTP_LOG_W("Kiss-o'-Death received: %s", code);
+        usecOut = 0;
+        return 0;
     }
     
-    return false;
-}
-
-time_t NTPClient::parseNTPPacket(const NTPPacket& packet, uint16_t& rtt, uint32_t& usecOut) {
     // Extract transmit timestamp - BOTH integer and fractional parts
-    uint32_t txTm_s = ntohl(packet.txTm_s);
-    uint32_t txTm_f = ntohl(packet.txTm_f);
+    uint32_t txTm_s = packet.transmitSeconds();
+    uint32_t txTm_f = packet.transmitFraction();
 
     // Convert NTP fractional seconds to microseconds
     // NTP fraction is in units of 2^-32 seconds (~232 picoseconds)
@@ -553,10 +367,10 @@ time_t NTPClient::parseNTPPacket(const NTPPacket& packet, uint16_t& rtt, uint32_
     // Enhanced debug logging - log all timestamps
     NTP_LOG_V("=== NTP Packet Debug ===");
     NTP_LOG_V("Stratum: %d, Mode: %d, Version: %d",
-              packet.stratum, packet.li_vn_mode & 0x07, (packet.li_vn_mode >> 3) & 0x07);
-    NTP_LOG_V("Reference ID: 0x%08X", ntohl(packet.refId));
-    NTP_LOG_V("Reference time: %lu.%lu", ntohl(packet.refTm_s), ntohl(packet.refTm_f));
-    NTP_LOG_V("Origin time: %lu.%lu", ntohl(packet.origTm_s), ntohl(packet.origTm_f));
+              packet.stratum(), packet.mode(), packet.version());
+    NTP_LOG_V("Reference ID: 0x%08X", packet.referenceId());
+    NTP_LOG_V("Reference time: %lu.%lu", packet.referenceSeconds(), packet.referenceFraction());
+    NTP_LOG_V("Origin time: %lu.%lu", packet.originSeconds(), packet.originFraction());
     NTP_LOG_V("Transmit time: %lu.%lu (0x%08X) -> %lu usec", txTm_s, txTm_f, txTm_s, usecOut);
     NTP_LOG_V("NTP_TIMESTAMP_DELTA: %lu", NTP_TIMESTAMP_DELTA);
 
@@ -599,65 +413,31 @@ time_t NTPClient::parseNTPPacket(const NTPPacket& packet, uint16_t& rtt, uint32_
         usecOut -= 1000000;
     }
 
-    NTP_LOG_V("NTP time: %ld.%06lu (after RTT adjustment), Stratum: %d", ntpTime, usecOut, packet.stratum);
+    NTP_LOG_V("NTP time: %ld.%06lu (after RTT adjustment), Stratum: %d", ntpTime, usecOut, packet.stratum());
 
     return ntpTime;
 }
 
-void NTPClient::updateServerStats(NTPServer& server, bool success, int32_t offset, uint16_t rtt) {
-    if (success) {
-        server.lastSuccessTime = time(nullptr);
-        server.failureCount = 0;
-        
-        // Update running averages (exponential moving average)
-        if (server.averageOffset == 0) {
-            server.averageOffset = offset;
-            server.averageRTT = rtt;
-        } else {
-            server.averageOffset = (int32_t)((1.0f - OFFSET_FILTER_ALPHA) * server.averageOffset + 
-                                            OFFSET_FILTER_ALPHA * offset);
-            server.averageRTT = (uint16_t)((1.0f - OFFSET_FILTER_ALPHA) * server.averageRTT + 
-                                          OFFSET_FILTER_ALPHA * rtt);
-        }
-    } else {
-        server.failureCount++;
-        
-        // Mark as unreachable after too many failures
-        if (server.failureCount >= MAX_RETRY_COUNT) {
-            server.reachable = false;
-            NTP_LOG_W("Server %s marked as unreachable", server.hostname.c_str());
-        }
-    }
-}
-
-time_t NTPClient::getDSTTransition(int year, uint8_t month, uint8_t week, 
-                                   uint8_t dayOfWeek, uint8_t hour) const {
-    struct tm timeinfo = {0};
-    timeinfo.tm_year = year - 1900;
-    timeinfo.tm_mon = month - 1;
-    timeinfo.tm_mday = 1;
-    timeinfo.tm_hour = hour;
-    
-    time_t firstDay = mktime(&timeinfo);
-    struct tm* firstDayTm = gmtime(&firstDay);
-    int firstDayOfWeek = firstDayTm->tm_wday;
+void NTPClientBase::handleKissOfDeath(NTPServer& server, uint32_t code, uint32_t nowMs) {
+    server.kissCode = code;
     
-    int daysUntilTarget = (dayOfWeek - firstDayOfWeek + 7) % 7;
-    int targetDay = 1 + daysUntilTarget + (week - 1) * 7;
-    
-    // Handle "last" week of month
-    if (week == 5) {
-        int daysInMon = daysInMonth(month, year);
-        while (targetDay > daysInMon) {
-            targetDay -= 7;
+    if (code == KISS_DENY || code == KISS_RSTR) {
+        // The server refuses to serve us; asking again only makes it worse
+        server.denied = true;
+        server.reachable = false;
+        NTP_LOG_E("Server %s denied access, demoted permanently", server.hostname);
+    } else if (code == KISS_RATE) {
+        if (server.rateBackoff < MAX_RATE_BACKOFF) {
+            server.rateBackoff++;
         }
+        uint32_t holdoffSeconds = MIN_SYNC_INTERVAL << server.rateBackoff;
+        server.holdoffUntilMs = nowMs + holdoffSeconds * 1000;
+        NTP_LOG_W("Server %s is rate limiting, backing off %lus",
+                  server.hostname, holdoffSeconds);
     }
-    
-    timeinfo.tm_mday = targetDay;
-    return mktime(&timeinfo);
 }
 
-void NTPClient::applyTimeOffset(time_t newTime, uint32_t usec) {
+void NTPClientBase::applyTimeOffset(time_t newTime, uint32_t usec) {
     time_t oldTime = time(nullptr);
 
     struct timeval tv;
@@ -667,15 +447,76 @@ void NTPClient::applyTimeOffset(time_t newTime, uint32_t usec) {
 
     NTP_LOG_D("Applied time: %ld.%06lu (usec from NTP fractions)", newTime, usec);
 
-    if (_timeChangeCallback) {
-        _timeChangeCallback(oldTime, newTime);
+    notifyTimeChange(oldTime, newTime);
+}
+
+void NTPClientBase::setDeferredCallbacks(bool enable, bool dispatchFromProcess) {
+    if (!enable) {
+        dispatchPendingCallbacks();  // Deliver what is queued before going inline
     }
+    _deferCallbacks = enable;
+    _dispatchFromProcess = dispatchFromProcess;
+    NTP_LOG_I("Deferred callbacks %s", enable ? "enabled" : "disabled");
+}
+
+void NTPClientBase::notifySync(const SyncResult& result) {
+    if (_deferCallbacks) {
+        DeferredEvent event;
+        event.result = result;
+        event.type = EVENT_SYNC;
+        queueEvent(event);
+        return;
+    }
+    
+    _syncListeners(result);
+    if (_rtcCallback) {
+        _rtcCallback(result.syncTime);
+    }
+}
+
+void NTPClientBase::notifyTimeChange(time_t oldTime, time_t newTime) {
+    if (_deferCallbacks) {
+        DeferredEvent event;
+        event.oldTime = oldTime;
+        event.newTime = newTime;
+        event.type = EVENT_TIME_CHANGE;
+        queueEvent(event);
+        return;
+    }
+    
+    _timeChangeListeners(oldTime, newTime);
+}
+
+void NTPClientBase::queueEvent(const DeferredEvent& event) {
+    if (!_deferredEvents.push(event)) {
+        _droppedEvents++;
+        NTP_LOG_W("Deferred callback queue full, event dropped");
+    }
+}
+
+uint8_t NTPClientBase::dispatchPendingCallbacks() {
+    uint8_t delivered = 0;
+    DeferredEvent event;
+    
+    while (_deferredEvents.pop(event)) {
+        if (event.type == EVENT_SYNC) {
+            _syncListeners(event.result);
+            if (_rtcCallback) {
+                _rtcCallback(event.result.syncTime);
+            }
+        } else {
+            _timeChangeListeners(event.oldTime, event.newTime);
+        }
+        delivered++;
+    }
+    
+    return delivered;
 }
 
 // Static utility methods
-String NTPClient::epochToString(time_t epoch, const char* format) {
+String NTPClientBase::epochToString(time_t epoch, const char* format) {
     struct tm timeinfo;
-    localtime_r(&epoch, &timeinfo);
+    NTPCalendar::toTm(epoch, timeinfo);
     
     char buffer[80];
     strftime(buffer, sizeof(buffer), format, &timeinfo);
@@ -683,35 +524,65 @@ String NTPClient::epochToString(time_t epoch, const char* format) {
     return String(buffer);
 }
 
-time_t NTPClient::makeTime(int year, int month, int day, 
+bool NTPClientBase::parseTime(const char* text, time_t& utc, uint32_t& nanos) {
+    int64_t seconds;
+    if (!NTPFormat::parseRFC3339(text, seconds, nanos)) return false;
+    if ((int64_t)(time_t)seconds != seconds) return false;  // Beyond a 32-bit time_t
+    utc = (time_t)seconds;
+    return true;
+}
+
+time_t NTPClientBase::makeTime(int year, int month, int day, 
                           int hour, int minute, int second) {
-    struct tm timeinfo = {0};
-    timeinfo.tm_year = year - 1900;
-    timeinfo.tm_mon = month - 1;
-    timeinfo.tm_mday = day;
-    timeinfo.tm_hour = hour;
-    timeinfo.tm_min = minute;
-    timeinfo.tm_sec = second;
-    
-    return mktime(&timeinfo);
+    // Out-of-range fields carry over as with mktime()
+    return (time_t)NTPCalendar::toEpochNormalized(year, month, day, hour, minute, second);
 }
 
-bool NTPClient::isLeapYear(int year) {
-    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+void NTPClientBase::kissCodeToString(uint32_t code, char (&out)[5]) {
+    for (uint8_t i = 0; i < 4; i++) {
+        char c = (char)(code >> (24 - 8 * i));
+        out[i] = (c >= 0x20 && c < 0x7F) ? c : '?';
+    }
+    out[4] = '\0';
 }
 
-uint8_t NTPClient::daysInMonth(int month, int year) {
-    static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
-    
-    if (month == 2 && isLeapYear(year)) {
-        return 29;
+const char* NTPClientBase::errorToString(SyncError error) {
+    switch (error) {
+        case SyncError::NONE:               return "OK";
+        case SyncError::NOT_INITIALIZED:    return "NTP client not initialized";
+        case SyncError::SEND_FAILED:        return "Failed to send NTP packet";
+        case SyncError::TIMEOUT:            return "Timeout waiting for NTP response";
+        case SyncError::INVALID_PACKET:     return "Invalid NTP packet received";
+        case SyncError::KISS_OF_DEATH:      return "Kiss-o'-Death received";
+        case SyncError::ALL_SERVERS_FAILED: return "Failed to sync with any server";
+        case SyncError::DEADLINE_EXCEEDED:  return "Sync deadline exceeded";
     }
+    return "Unknown error";
+}
+
+const char* NTPClientBase::SyncResult::toString(char* buffer, size_t length) const {
+    if (length == 0) return buffer;
     
-    return days[month - 1];
+    if (error == SyncError::KISS_OF_DEATH) {
+        char code[5];
+        kissCodeToString(errorDetail, code);
+        snprintf(buffer, length, "%s: %s", errorToString(error), code);
+    } else {
+        snprintf(buffer, length, "%s", errorToString(error));
+    }
+    return buffer;
+}
+
+bool NTPClientBase::isLeapYear(int year) {
+    return NTPCalendar::isLeapYear(year);
+}
+
+uint8_t NTPClientBase::daysInMonth(int month, int year) {
+    return NTPCalendar::daysInMonth(year, month);
 }
 
 // Time zone presets
-NTPClient::TimeZoneConfig NTPClient::getTimeZoneEST() {
+NTPClientBase::TimeZoneConfig NTPClientBase::getTimeZoneEST() {
     return {
         -300,      // UTC-5 hours
         "EST",
@@ -722,7 +593,7 @@ NTPClient::TimeZoneConfig NTPClient::getTimeZoneEST() {
     };
 }
 
-NTPClient::TimeZoneConfig NTPClient::getTimeZonePST() {
+NTPClientBase::TimeZoneConfig NTPClientBase::getTimeZonePST() {
     return {
         -480,      // UTC-8 hours
         "PST",
@@ -733,7 +604,7 @@ NTPClient::TimeZoneConfig NTPClient::getTimeZonePST() {
     };
 }
 
-NTPClient::TimeZoneConfig NTPClient::getTimeZoneCET() {
+NTPClientBase::TimeZoneConfig NTPClientBase::getTimeZoneCET() {
     return {
         60,        // UTC+1 hour
         "CET",
@@ -744,7 +615,7 @@ NTPClient::TimeZoneConfig NTPClient::getTimeZoneCET() {
     };
 }
 
-NTPClient::TimeZoneConfig NTPClient::getTimeZoneUTC() {
+NTPClientBase::TimeZoneConfig NTPClientBase::getTimeZoneUTC() {
     return {
         0,         // No offset
         "UTC",
@@ -753,4 +624,4 @@ NTPClient::TimeZoneConfig NTPClient::getTimeZoneUTC() {
         0, 0, 0, 0,
         0
     };
-}
\ No newline at end of file
+}
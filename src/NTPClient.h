@@ -19,13 +19,24 @@
 #endif
 
 #include <time.h>
-#include <vector>
-#include <functional>
+#include <array>
+#include "NTPCalendar.h"
+#include "NTPCallback.h"
 #include "NTPClientLogging.h"
+#include "NTPFormat.h"
+#include "NTPPacketView.h"
+#include "NTPTimeZone.h"
+#include "NTPTimerWheel.h"
 
-class NTPClient {
+/**
+ * Transport-independent part of the client: packet and server types, time
+ * zone handling, time getters, statistics and callbacks. Everything that
+ * touches the socket or the server table lives in BasicNTPClient below.
+ */
+class NTPClientBase {
 public:
-    // NTP packet structure
+    // NTP packet structure (field layout only; the client decodes replies
+    // in place with NTPPacketView)
     struct NTPPacket {
         uint8_t  li_vn_mode;      // Eight bits: li(2), vn(3), mode(3)
         uint8_t  stratum;         // Stratum level of the local clock
@@ -43,89 +54,189 @@ public:
         uint32_t txTm_s;          // Transmit time-stamp seconds
         uint32_t txTm_f;          // Transmit time-stamp fraction of a second
     } __attribute__((packed));
+    static_assert(sizeof(NTPPacket) == NTPPacketView::SIZE, "NTPPacket must match the wire size");
+    static_assert(offsetof(NTPPacket, txTm_s) == NTPPacketView::TRANSMIT_TIMESTAMP,
+                  "NTPPacket layout must match NTPPacketView offsets");
 
-    // Server configuration
+    static constexpr uint8_t MAX_HOSTNAME_LENGTH = 63;  // Excluding the terminating null
+    
+    // Server configuration. Fields read by every server scan (getBestServer(),
+    // usable()) come first so a scan touches one contiguous block per entry;
+    // the hostname and bookkeeping follow.
     struct NTPServer {
-        String hostname;
-        uint16_t port;
-        uint32_t lastSuccessTime;
-        uint32_t failureCount;
-        int32_t averageOffset;    // Running average offset in ms
-        uint16_t averageRTT;      // Running average round-trip time in ms
         bool reachable;
+        bool denied;              // DENY/RSTR received: never asked again
+        uint8_t rateBackoff;      // Poll interval doubling exponent after RATE kisses
         uint8_t stratum;          // Server's stratum level
+        uint32_t failureCount;
+        uint32_t holdoffUntilMs;  // millis() before which a rate-limited server is skipped
+        uint16_t averageRTT;      // Running average round-trip time in ms
+        uint16_t srtt;            // Smoothed RTT in ms (0 = no sample yet)
+        uint16_t rttVar;          // RTT variation in ms
+        uint16_t rto;             // Retransmission timeout in ms (SRTT + 4*RTTVAR)
+        int32_t averageOffset;    // Running average offset in ms
+        uint32_t lastSuccessTime;
+        uint32_t pollInterval;    // Seconds between statistics probes under auto-sync, 0 = none
+        uint32_t reprobeInterval; // Seconds until the next re-probe while unreachable
+        uint32_t kissCode;        // Last Kiss-o'-Death code (e.g. KISS_RATE), 0 if none
+        uint16_t port;
+        uint8_t reach;            // Reachability register, one bit per poll (1 = answered)
+        char hostname[MAX_HOSTNAME_LENGTH + 1];
+        
+        // Inside the holdoff after a RATE kiss: not to be asked at all
+        bool heldOff(uint32_t nowMs) const {
+            return rateBackoff > 0 && (int32_t)(nowMs - holdoffUntilMs) < 0;
+        }
+        
+        // Reachable, not denied and not inside a RATE holdoff
+        bool usable(uint32_t nowMs) const {
+            return reachable && !denied && !heldOff(nowMs);
+        }
+        
+        static constexpr uint16_t INITIAL_RTO_MS = 1000;
+        static constexpr uint16_t MIN_RTO_MS = 20;
+        static constexpr uint16_t MAX_RTO_MS = 5000;
+        
+        // Fold an RTT sample into SRTT/RTTVAR and recompute the RTO (RFC 6298)
+        void updateRTO(uint16_t rttMs) {
+            if (rttMs == 0) rttMs = 1;  // Keep srtt == 0 meaning "no sample"
+            if (srtt == 0) {
+                srtt = rttMs;
+                rttVar = rttMs / 2;
+            } else {
+                uint16_t delta = srtt > rttMs ? srtt - rttMs : rttMs - srtt;
+                rttVar = (uint16_t)((3UL * rttVar + delta) / 4);
+                srtt = (uint16_t)((7UL * srtt + rttMs) / 8);
+            }
+            uint32_t timeout = (uint32_t)srtt + 4UL * rttVar;
+            rto = (uint16_t)(timeout < MIN_RTO_MS ? MIN_RTO_MS :
+                             timeout > MAX_RTO_MS ? MAX_RTO_MS : timeout);
+        }
+        
+        // Rough 95th percentile RTT, SRTT + 2*RTTVAR; the RTO until sampled
+        uint16_t rttP95() const {
+            if (srtt == 0) return rto;
+            uint32_t p95 = (uint32_t)srtt + 2UL * rttVar;
+            return (uint16_t)(p95 > MAX_RTO_MS ? MAX_RTO_MS : p95);
+        }
+        
+        // Selection score, lower is better: stratum, then failures, then RTT
+        uint32_t score() const {
+            return (stratum * 1000UL) + (failureCount * 100UL) + averageRTT;
+        }
+        
+        // Exponential backoff after a lost reply (Karn's algorithm)
+        void backoffRTO() {
+            rto = (uint16_t)(rto >= MAX_RTO_MS / 2 ? MAX_RTO_MS : rto * 2);
+        }
     };
 
-    // Sync result
+    // Kiss-o'-Death codes (RFC 5905 7.4), sent in refId with stratum 0
+    static constexpr uint32_t KISS_RATE = 0x52415445UL;  // "RATE": reduce poll rate
+    static constexpr uint32_t KISS_DENY = 0x44454E59UL;  // "DENY": access denied
+    static constexpr uint32_t KISS_RSTR = 0x52535452UL;  // "RSTR": access restricted
+    
+    // Read-only view of the configured servers; iterating it never allocates
+    class ServerList {
+    public:
+        ServerList(const NTPServer* servers, uint8_t count) : _begin(servers), _count(count) {}
+        const NTPServer* begin() const { return _begin; }
+        const NTPServer* end() const { return _begin + _count; }
+        uint8_t size() const { return _count; }
+        bool empty() const { return _count == 0; }
+        const NTPServer& operator[](uint8_t index) const { return _begin[index]; }
+    private:
+        const NTPServer* _begin;
+        uint8_t _count;
+    };
+    
+    static constexpr uint8_t NO_SERVER = 0xFF;  // Index of a host not in the server table
+    
+    // Why a sync failed
+    enum class SyncError : uint8_t {
+        NONE = 0,
+        NOT_INITIALIZED,          // begin() has not been called
+        SEND_FAILED,              // UDP packet could not be sent
+        TIMEOUT,                  // No matching reply in time
+        INVALID_PACKET,           // Reply failed validation
+        KISS_OF_DEATH,            // Server sent a KoD; errorDetail holds the code
+        ALL_SERVERS_FAILED,       // Every usable server was tried
+        DEADLINE_EXCEEDED         // syncTime() ran out of its total budget
+    };
+    
+    // Sync result. Small enough to copy freely or keep a history of.
     struct SyncResult {
         time_t syncTime;          // When sync occurred (8 bytes, aligned first)
-        char serverUsed[64];      // Server hostname/IP (max 63 chars + null)
-        char error[128];          // Error message if failed (max 127 chars + null)
         int32_t offsetMs;         // Time offset in milliseconds (true ms precision)
         uint32_t syncUsec;        // Microseconds component of sync time (0-999999)
+        uint32_t errorDetail;     // Error-specific detail, e.g. the KoD code; 0 if none
         uint16_t roundTripMs;     // Round trip time in milliseconds
         uint8_t stratum;          // Server stratum
+        uint8_t serverIndex;      // Server answering or last tried, NO_SERVER if unlisted
+        SyncError error;          // SyncError::NONE on success
         bool success;             // Success flag
 
-        // Constructor to initialize char arrays
-        SyncResult() : syncTime(0), offsetMs(0), syncUsec(0), roundTripMs(0), stratum(0), success(false) {
-            serverUsed[0] = '\0';
-            error[0] = '\0';
-        }
+        SyncResult() : syncTime(0), offsetMs(0), syncUsec(0), errorDetail(0), roundTripMs(0),
+                       stratum(0), serverIndex(NO_SERVER), error(SyncError::NONE), success(false) {}
+        
+        // Human-readable outcome for logging, e.g. "Kiss-o'-Death received: RATE"
+        const char* toString(char* buffer, size_t length) const;
     };
 
-    // Time zone configuration
-    struct TimeZoneConfig {
-        int16_t offsetMinutes;    // UTC offset in minutes
-        String name;              // e.g., "EST", "PST"
-        bool useDST;              // Use daylight saving time
-        uint8_t dstStartWeek;     // Week of month (1-5, 5=last)
-        uint8_t dstStartMonth;    // Month (1-12)
-        uint8_t dstStartDayOfWeek;// Day of week (0=Sunday)
-        uint8_t dstStartHour;     // Hour to start DST
-        uint8_t dstEndWeek;       // Week of month (1-5, 5=last)
-        uint8_t dstEndMonth;      // Month (1-12)
-        uint8_t dstEndDayOfWeek;  // Day of week (0=Sunday)
-        uint8_t dstEndHour;       // Hour to end DST
-        int16_t dstOffsetMinutes; // Additional offset during DST
-    };
+    // Time zone types (see NTPTimeZone.h)
+    using TimeZoneConfig = NTPTimeZone::Config;
+    using ZoneInterval = NTPTimeZone::Interval;
+    using DSTRule = NTPTimeZone::DSTRule;
+    static constexpr DSTRule DST_RULE_MONTH_WEEK_DAY = NTPTimeZone::DST_RULE_MONTH_WEEK_DAY;
+    static constexpr DSTRule DST_RULE_JULIAN_DAY = NTPTimeZone::DST_RULE_JULIAN_DAY;
+    static constexpr DSTRule DST_RULE_DAY_OF_YEAR = NTPTimeZone::DST_RULE_DAY_OF_YEAR;
+    static constexpr uint8_t MAX_TZ_NAME_LENGTH = NTPTimeZone::MAX_NAME_LENGTH;
 
-    // Callbacks
-    using SyncCallback = std::function<void(const SyncResult&)>;
-    using TimeChangeCallback = std::function<void(time_t oldTime, time_t newTime)>;
-    using YieldCallback = std::function<void()>;
-
-    // Constructor/Destructor
-    NTPClient();
-    ~NTPClient() = default;
-
-    // Configuration
-    void begin(uint16_t localPort = 8888);
-    void beginWithDefaults(uint16_t localPort = 8888);  // Explicitly add default servers
-    void end();
-    
-    // Server management
-    [[nodiscard]] bool addServer(const String& hostname, uint16_t port = 123);
-    [[nodiscard]] bool removeServer(const String& hostname);
-    void clearServers();
-    [[nodiscard]] std::vector<NTPServer> getServers() const { return _servers; }
-    [[nodiscard]] NTPServer* getBestServer();
+    // Callbacks. Stored inline (NTP_CALLBACK_STORAGE bytes each), never on the heap.
+    using SyncCallback = NTPInplaceFunction<void(const SyncResult&)>;
+    using TimeChangeCallback = NTPInplaceFunction<void(time_t oldTime, time_t newTime)>;
+    using YieldCallback = NTPInplaceFunction<void()>;
+    using RTCCallback = NTPInplaceFunction<void(time_t)>;
+    static constexpr uint8_t MAX_LISTENERS = 4;  // Per event, including the onXxx() callback
 
-    // Time synchronization
-    [[nodiscard]] SyncResult syncTime(uint32_t timeoutMs = 5000);
-    [[nodiscard]] SyncResult syncTimeFromServer(const String& hostname, uint32_t timeoutMs = 5000);
-    [[nodiscard]] bool forceSync();
+    // Hedged requests: when the best server has not answered within its
+    // p95 RTT, syncTime() also asks the runner-up and uses the first reply
+    void setHedging(bool enable);
+    [[nodiscard]] bool isHedgingEnabled() const noexcept { return _hedgingEnabled; }
 
     // Automatic sync
-    void setAutoSync(bool enable, uint32_t intervalSeconds = 3600);
     [[nodiscard]] bool isAutoSyncEnabled() const noexcept { return _autoSyncEnabled; }
     [[nodiscard]] uint32_t getAutoSyncInterval() const noexcept { return _autoSyncInterval; }
+    // Total budget of each automatic syncTime(), shared across servers
+    void setSyncTimeout(uint32_t timeoutMs) noexcept { _syncTimeout = timeoutMs; }
+    [[nodiscard]] uint32_t getSyncTimeout() const noexcept { return _syncTimeout; }
     [[nodiscard]] time_t getLastSyncTime() const noexcept { return _lastSyncTime; }
-    [[nodiscard]] time_t getNextSyncTime() const;
+    
+    // Load spreading: delay the first sync by a per-device phase in
+    // [0, firstSyncSpreadSeconds] and randomize each poll interval by
+    // +/- intervalJitterPercent. Both are derived from the device MAC
+    // unless a seed is given, so a fleet spreads out deterministically.
+    void setSyncJitter(uint32_t firstSyncSpreadSeconds, uint8_t intervalJitterPercent = 10);
+    void setJitterSeed(uint32_t seed);
 
     // Time zone management
     void setTimeZone(const TimeZoneConfig& config);
-    [[nodiscard]] TimeZoneConfig getTimeZone() const noexcept { return _timezone; }
+    // POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3". Returns false and
+    // keeps the current zone if the string is malformed.
+    bool setTimeZone(const char* posixTZ);
+    static bool parseTimeZone(const char* posixTZ, TimeZoneConfig& out) { return NTPTimeZone::parse(posixTZ, out); }
+    
+    // Compiled IANA zones (src/NTPZoneData.h, generated by
+    // tools/gen_zone_data.py). Historical transitions come from the table,
+    // later ones from the zone's POSIX rule.
+    bool setTimeZone(NTPZoneId zone);
+    void setTimeZone(const NTPTimeZone& zone);
+    [[nodiscard]] const NTPTimeZone& getZone() const noexcept { return _zone; }
+    [[nodiscard]] NTPZoneId getTimeZoneId() const noexcept { return _zone.id(); }  // NTP_ZONE_NONE if rule-based
+    static NTPZoneId findZone(const char* ianaName) { return NTPTimeZone::find(ianaName); }
+    static const char* getZoneName(NTPZoneId zone) { return NTPTimeZone::zoneName(zone); }
+    static bool lookupZone(NTPZoneId zone, time_t utc, ZoneInterval& out);
+    [[nodiscard]] TimeZoneConfig getTimeZone() const noexcept { return _zone.config(); }
     [[nodiscard]] bool isDST() const;
     [[nodiscard]] bool isDST(time_t timestamp) const;
     
@@ -138,8 +249,68 @@ public:
     // Time getters
     [[nodiscard]] time_t getEpochTime() const;
     [[nodiscard]] time_t getLocalTime() const;
+    [[nodiscard]] time_t getLocalTime(NTPZoneId zone) const;
+    
+    // Conversion into any zone, independent of the client's own. Each
+    // handle caches its current offset interval, so rendering one instant
+    // in N zones costs N cache checks.
+    static time_t toLocal(time_t utc, const NTPTimeZone& zone) { return zone.toLocal(utc); }
+    static size_t formatLocal(time_t utc, const NTPTimeZone& zone, char* buffer, size_t length,
+                              const char* format = "%Y-%m-%d %H:%M:%S");
+    template <size_t N>
+    static size_t formatLocal(time_t utc, const NTPTimeZone& zone, char (&buffer)[N],
+                              const char* format = "%Y-%m-%d %H:%M:%S") {
+        return formatLocal(utc, zone, buffer, N, format);
+    }
+    
+    // Render `count` UTC instants into one buffer, each followed by
+    // `separator` except the last, null-terminated. Sorted input reuses
+    // the offset interval and the formatted date (see NTPFormatMemo).
+    // Returns how many instants fit; nothing is allocated.
+    static size_t formatBatch(const time_t* utc, size_t count, const NTPTimeZone& zone,
+                              NTPTimeFormat format, char* buffer, size_t length, char separator = '\n');
+    
+    // RFC 3339 local time with 0-9 fraction digits and the UTC offset,
+    // e.g. "2024-07-01T14:00:00.123+02:00". No strftime() or locale; see
+    // NTPFormat.h. Return the length written, 0 if the buffer is too small.
+    size_t formatRFC3339(char* buffer, size_t length, uint8_t fractionDigits = 3) const;
+    template <size_t N>
+    size_t formatRFC3339(char (&buffer)[N], uint8_t fractionDigits = 3) const {
+        return formatRFC3339(buffer, N, fractionDigits);
+    }
+    static size_t formatRFC3339(time_t utc, uint32_t nanos, const NTPTimeZone& zone,
+                                char* buffer, size_t length, uint8_t fractionDigits = 3);
+    
+    // Reentrant formatting into caller buffers: no shared buffer, memo or
+    // zone cache is touched, so any number of tasks may call these at once.
+    // Return the length written, 0 if the time is not synced or the buffer
+    // is too small.
+    using FormattedTime = std::array<char, NTPFormat::RFC3339_MAX_LENGTH + 1>;
+    size_t formatTime(char* buffer, size_t length, NTPTimeFormat format = NTPTimeFormat::DATE_TIME) const;
+    size_t formatTime(char* buffer, size_t length, const char* format) const;  // strftime()
+    template <size_t N>
+    size_t formatTime(char (&buffer)[N], NTPTimeFormat format = NTPTimeFormat::DATE_TIME) const {
+        return formatTime(buffer, N, format);
+    }
+    [[nodiscard]] FormattedTime formatTime(NTPTimeFormat format = NTPTimeFormat::DATE_TIME) const;
+    // Pattern compiled at build time (see NTPFixedFormat); unsupported
+    // conversions and a too-small buffer are compile errors
+    template <const char* Pattern, size_t N>
+    size_t formatTime(char (&buffer)[N]) const {
+        static_assert(N > NTPFixedFormat<Pattern>::LENGTH, "Buffer too small for this time format");
+        time_t now = time(nullptr);
+        int16_t offsetMinutes = offsetMinutesAt(now);
+        if (now + offsetMinutes * 60L < 86400) {  // Not synced
+            buffer[0] = '\0';
+            return 0;
+        }
+        return NTPFixedFormat<Pattern>::format(now, offsetMinutes, buffer, N);
+    }
+    
+    // Pointer into a shared internal buffer; not reentrant, copy before the next call
     [[nodiscard]] const char* getFormattedTime() const;
     [[nodiscard]] const char* getFormattedTime(const char* format) const;
+    [[nodiscard]] const char* getFormattedTime(NTPTimeFormat format) const;  // Memoized per second
     [[nodiscard]] const char* getFormattedDate() const;
     [[nodiscard]] const char* getFormattedDateTime() const;
     
@@ -148,7 +319,7 @@ public:
     void adjustTime(int32_t offsetSeconds);
     
     // RTC integration
-    void setRTCCallback(std::function<void(time_t)> callback) { _rtcCallback = callback; }
+    void setRTCCallback(RTCCallback callback) { _rtcCallback = std::move(callback); }
     void syncToRTC();
     
     // Statistics and diagnostics
@@ -156,33 +327,77 @@ public:
     [[nodiscard]] uint32_t getSyncFailures() const noexcept { return _syncFailures; }
     [[nodiscard]] float getAverageSyncTime() const noexcept { return _averageSyncTime; }
     [[nodiscard]] int32_t getLastOffset() const noexcept { return _lastOffset; }
-    void printDiagnostics();
-    void resetStatistics();
     
-    // Callbacks
-    void onSync(SyncCallback callback) { _syncCallback = callback; }
-    void onTimeChange(TimeChangeCallback callback) { _timeChangeCallback = callback; }
-    void setYieldCallback(YieldCallback callback) { _yieldCallback = callback; }
+    // Callbacks. onSync()/onTimeChange() set (or replace) the main callback;
+    // the add*Listener() calls subscribe further observers alongside it and
+    // return an id for removal, or -1 when MAX_LISTENERS is reached.
+    void onSync(SyncCallback callback) { _syncListeners.setPrimary(std::move(callback)); }
+    void onTimeChange(TimeChangeCallback callback) { _timeChangeListeners.setPrimary(std::move(callback)); }
+    [[nodiscard]] int8_t addSyncListener(SyncCallback callback) { return _syncListeners.add(std::move(callback)); }
+    bool removeSyncListener(int8_t id) { return _syncListeners.remove(id); }
+    [[nodiscard]] int8_t addTimeChangeListener(TimeChangeCallback callback) {
+        return _timeChangeListeners.add(std::move(callback));
+    }
+    bool removeTimeChangeListener(int8_t id) { return _timeChangeListeners.remove(id); }
+    void setYieldCallback(YieldCallback callback) { _yieldCallback = std::move(callback); }
+    
+    // Deferred callbacks: sync, RTC and time-change callbacks are queued
+    // instead of running inside the sync, and are delivered by process()
+    // or, with dispatchFromProcess = false, by the caller's own worker via
+    // dispatchPendingCallbacks(). Only one task may dispatch.
+    static constexpr uint8_t DEFERRED_QUEUE_SIZE = 4;
+    void setDeferredCallbacks(bool enable, bool dispatchFromProcess = true);
+    [[nodiscard]] bool isDeferredCallbacks() const noexcept { return _deferCallbacks; }
+    [[nodiscard]] bool hasPendingCallbacks() const { return !_deferredEvents.empty(); }
+    uint8_t dispatchPendingCallbacks();  // Returns the number of events delivered
+    [[nodiscard]] uint32_t getDroppedCallbackCount() const noexcept { return _droppedEvents; }
     
-    // Utility methods
+    // Utility methods. Times are taken as-is (UTC or already-local) and do
+    // not depend on the process TZ environment.
     static String epochToString(time_t epoch, const char* format = "%Y-%m-%d %H:%M:%S");
+    // RFC 3339 / ISO 8601 timestamp to UTC (see NTPFormat::parseRFC3339()).
+    // False for times time_t cannot hold, e.g. after 2038 with a 32-bit time_t.
+    static bool parseTime(const char* text, time_t& utc, uint32_t& nanos);
+    static bool parseTime(const char* text, time_t& utc) {
+        uint32_t nanos;
+        return parseTime(text, utc, nanos);
+    }
+    // UTC; out-of-range or negative fields carry over as with mktime()
     static time_t makeTime(int year, int month, int day, int hour, int minute, int second);
     static bool isLeapYear(int year);
+    static void kissCodeToString(uint32_t code, char (&out)[5]);
+    static const char* errorToString(SyncError error);
     static uint8_t daysInMonth(int month, int year);
     
-    // Process (call in loop for auto-sync)
-    void process();
+    static constexpr uint32_t NO_PENDING_ACTION = UINT32_MAX;
 
-private:
-    NTP_UDP_CLASS _udp;
+protected:
+    NTPClientBase();
+    ~NTPClientBase() = default;  // Not deleted through a base pointer
+    
+    // Constants
+    static constexpr uint32_t NTP_TIMESTAMP_DELTA = 2208988800UL;  // 1900 to 1970
+    static constexpr uint32_t MIN_SYNC_INTERVAL = 60;              // 1 minute minimum
+    static constexpr uint32_t DEFAULT_NTP_PORT = 123;
+    static constexpr uint32_t DEFAULT_SYNC_TIMEOUT_MS = 5000;
+    static constexpr uint8_t NTP_PACKET_SIZE = 48;
+    static constexpr uint8_t MAX_RETRY_COUNT = 3;
+    static constexpr uint32_t MIN_REPROBE_INTERVAL = 64;    // First re-probe of a dead server
+    static constexpr uint32_t MAX_REPROBE_INTERVAL = 4096;  // Backoff cap (~68 minutes)
+    static constexpr uint8_t MAX_JITTER_PERCENT = 50;
+    static constexpr uint8_t MAX_PENDING_REQUESTS = 2;
+    static constexpr uint8_t MAX_RATE_BACKOFF = 6;      // RATE holdoff up to 64 minutes
+    static constexpr float OFFSET_FILTER_ALPHA = 0.1f;  // Exponential moving average filter
+    
     uint16_t _localPort;
-    std::vector<NTPServer> _servers;
-    TimeZoneConfig _timezone;
+    NTPTimeZone _zone;
+    mutable NTPTimeZone _lookupZone;  // Last zone passed to getLocalTime(NTPZoneId)
     
     // State
     bool _initialized;
     bool _autoSyncEnabled;
     uint32_t _autoSyncInterval;
+    uint32_t _syncTimeout;
     time_t _lastSyncTime;
     time_t _lastProcessTime;
     int32_t _lastOffset;
@@ -193,37 +408,213 @@ private:
     float _averageSyncTime;
     uint32_t _totalSyncTime;
     
+    // Poll spreading (see setSyncJitter())
+    uint32_t _firstSyncSpread;
+    uint8_t _jitterPercent;
+    uint32_t _jitterSeed;
+    uint32_t _jitterState;
+    
+    bool _hedgingEnabled;
+    
     // Internal buffer for formatted strings (prevents crash with c_str())
     mutable char _formattedBuffer[32];
+    mutable NTPFormatMemo _formatMemo;
     
     // Callbacks
-    SyncCallback _syncCallback;
-    TimeChangeCallback _timeChangeCallback;
-    std::function<void(time_t)> _rtcCallback;
+    NTPCallbackList<void(const SyncResult&), MAX_LISTENERS> _syncListeners;
+    NTPCallbackList<void(time_t, time_t), MAX_LISTENERS> _timeChangeListeners;
+    RTCCallback _rtcCallback;
     YieldCallback _yieldCallback;
     
-    // Internal methods
-    bool sendNTPPacket(const String& address);
-    bool receiveNTPPacket(NTPPacket& packet, uint32_t timeoutMs);
-    time_t parseNTPPacket(const NTPPacket& packet, uint16_t& rtt, uint32_t& usecOut);
-    void updateServerStats(NTPServer& server, bool success, int32_t offset, uint16_t rtt);
-    time_t getDSTTransition(int year, uint8_t month, uint8_t week, uint8_t dayOfWeek, uint8_t hour) const;
-    void applyTimeOffset(time_t newTime, uint32_t usec);
+    // Deferred callback events (see setDeferredCallbacks())
+    enum EventType : uint8_t { EVENT_SYNC, EVENT_TIME_CHANGE };
+    struct DeferredEvent {
+        SyncResult result;        // EVENT_SYNC; result.syncTime also feeds the RTC callback
+        time_t oldTime;           // EVENT_TIME_CHANGE
+        time_t newTime;
+        EventType type;
+    };
+    NTPEventQueue<DeferredEvent, DEFERRED_QUEUE_SIZE> _deferredEvents;
+    uint32_t _droppedEvents;
+    bool _deferCallbacks;
+    bool _dispatchFromProcess;
     
-    // Constants
-    static constexpr uint32_t NTP_TIMESTAMP_DELTA = 2208988800UL;  // 1900 to 1970
-    static constexpr uint32_t MIN_SYNC_INTERVAL = 60;              // 1 minute minimum
-    static constexpr uint32_t DEFAULT_NTP_PORT = 123;
-    static constexpr uint8_t NTP_PACKET_SIZE = 48;
-    static constexpr uint8_t MAX_SERVERS = 10;
-    static constexpr uint8_t MAX_RETRY_COUNT = 3;
-    static constexpr float OFFSET_FILTER_ALPHA = 0.1f;  // Exponential moving average filter
+    // Helpers that do not depend on the transport or the server table
+    int32_t offsetFromSystemMs(time_t ntpTime, uint32_t ntpUsec) const;
+    int16_t offsetMinutesAt(time_t utc) const;
+    time_t parseNTPPacket(const NTPPacketView& packet, uint16_t& rtt, uint32_t& usecOut, uint32_t& kissOut);
+    void handleKissOfDeath(NTPServer& server, uint32_t code, uint32_t nowMs);
+    void applyTimeOffset(time_t newTime, uint32_t usec);
+    void notifySync(const SyncResult& result);
+    void notifyTimeChange(time_t oldTime, time_t newTime);
+    void queueEvent(const DeferredEvent& event);
+    uint32_t jitteredInterval(uint32_t intervalSeconds);
+    uint32_t nextJitterRandom();
     
     // Default NTP servers
     static const char* DEFAULT_NTP_SERVERS[];
     static const uint8_t DEFAULT_SERVER_COUNT;
 };
 
+// Default time source of BasicNTPClient: the Arduino millisecond counter
+struct NTPArduinoClock {
+    static uint32_t millis() { return ::millis(); }
+    static void delay(uint32_t ms) { ::delay(ms); }
+};
+
+/**
+ * NTP client over the UDP transport `Udp`, with room for `MaxServers`
+ * servers. `Udp` needs the Arduino UDP interface used by WiFiUDP and
+ * EthernetUDP: begin(port), stop(), beginPacket(host, port), write(buf, len),
+ * endPacket(), parsePacket() and read(buf, len). Calls into it are direct,
+ * so clients on different transports can coexist in one program. `Clock`
+ * supplies millis() and delay(); tests substitute a simulated clock.
+ */
+template <typename Udp, uint8_t MaxServers = 10, typename Clock = NTPArduinoClock>
+class BasicNTPClient : public NTPClientBase {
+public:
+    static constexpr uint8_t MAX_SERVERS = MaxServers;
+    static_assert(MaxServers > 0, "A client needs room for at least one server");
+    static_assert(MaxServers <= 16, "syncTime() tracks attempted servers in a 16-bit mask");
+
+    BasicNTPClient();
+    ~BasicNTPClient() = default;
+    
+    // The underlying UDP object, e.g. to bind it to a specific interface
+    [[nodiscard]] Udp& getTransport() noexcept { return _udp; }
+
+    // Configuration
+    void begin(uint16_t localPort = 8888);
+    void beginWithDefaults(uint16_t localPort = 8888);  // Explicitly add default servers
+    void end();
+    
+    // Server management
+    // Servers live in a fixed table of MAX_SERVERS entries with inline
+    // hostnames (up to MAX_HOSTNAME_LENGTH chars), so nothing here allocates
+    [[nodiscard]] bool addServer(const char* hostname, uint16_t port = 123);
+    [[nodiscard]] bool addServer(const String& hostname, uint16_t port = 123) {
+        return addServer(hostname.c_str(), port);
+    }
+    [[nodiscard]] bool removeServer(const char* hostname);
+    [[nodiscard]] bool removeServer(const String& hostname) { return removeServer(hostname.c_str()); }
+    void clearServers();
+    [[nodiscard]] ServerList getServers() const noexcept { return ServerList(_servers, _serverCount); }
+    [[nodiscard]] uint8_t getServerCount() const noexcept { return _serverCount; }
+    [[nodiscard]] const NTPServer* getServer(uint8_t index) const noexcept {
+        return index < _serverCount ? &_servers[index] : nullptr;
+    }
+    // Hostname for a server index such as SyncResult::serverIndex, "?" if unlisted
+    [[nodiscard]] const char* getServerName(uint8_t index) const noexcept {
+        return index < _serverCount ? _servers[index].hostname : "?";
+    }
+    template <typename Visitor>
+    void forEachServer(Visitor&& visit) const {
+        for (uint8_t i = 0; i < _serverCount; i++) {
+            visit(_servers[i]);
+        }
+    }
+    [[nodiscard]] NTPServer* getBestServer();
+    // Probe one server for statistics every intervalSeconds while auto-sync
+    // is on, on top of the regular sync; 0 turns its probes off (default)
+    [[nodiscard]] bool setServerPollInterval(const char* hostname, uint32_t intervalSeconds);
+    [[nodiscard]] bool setServerPollInterval(const String& hostname, uint32_t intervalSeconds) {
+        return setServerPollInterval(hostname.c_str(), intervalSeconds);
+    }
+
+    // Time synchronization. syncTime() never spends more than timeoutMs in
+    // total, sharing the budget across servers and asking each at most once.
+    // While other servers remain, a server is given up on after its adaptive
+    // RTO so failover is fast; the last candidate gets the whole remainder.
+    [[nodiscard]] SyncResult syncTime(uint32_t timeoutMs = DEFAULT_SYNC_TIMEOUT_MS);
+    [[nodiscard]] SyncResult syncTimeFromServer(const char* hostname,
+                                                uint32_t timeoutMs = DEFAULT_SYNC_TIMEOUT_MS);
+    [[nodiscard]] SyncResult syncTimeFromServer(const String& hostname,
+                                                uint32_t timeoutMs = DEFAULT_SYNC_TIMEOUT_MS) {
+        return syncTimeFromServer(hostname.c_str(), timeoutMs);
+    }
+    [[nodiscard]] bool forceSync();
+    
+    // Automatic sync: one syncTime() with failover every intervalSeconds,
+    // after a successful sync from any source
+    void setAutoSync(bool enable, uint32_t intervalSeconds = 3600);
+    [[nodiscard]] time_t getNextSyncTime() const;
+    
+    // Statistics and diagnostics
+    void printDiagnostics();
+    void resetStatistics();
+    
+    // Process (call in loop for auto-sync, server probes and re-probes)
+    void process();
+    
+    // Power-aware scheduling: milliseconds until process() has work to do,
+    // or NO_PENDING_ACTION when nothing is scheduled. Sleep up to this long.
+    [[nodiscard]] uint32_t getMillisUntilNextAction() const;
+
+private:
+    Udp _udp;
+    NTPServer _servers[MaxServers];
+    uint8_t _serverCount;
+    
+    // Poll scheduling, one tick per second of millis(): an entry per server
+    // for probes and re-probes, plus SYNC_ENTRY for the clock-setting sync
+    static constexpr uint8_t SYNC_ENTRY = MaxServers;
+    NTPTimerWheel<MaxServers + 1> _pollWheel;
+    uint32_t _pollWheelMs;        // millis() at the last whole tick
+    uint32_t _pollWheelTick;      // That tick; process() has advanced the wheel to it
+    bool _pollWheelAdvancing;     // Inside _pollWheel.advance(): do not reset or move it
+    uint32_t _nextActionMs;       // millis() at which process() next has work
+    bool _actionPending;
+    
+    // Outstanding requests; a hedged sync has two in flight on one socket.
+    // Replies are matched by the originate timestamp the server echoes back.
+    enum RequestState : uint8_t { REQUEST_IDLE, REQUEST_WAITING, REQUEST_LATE };
+    struct PendingRequest {
+        uint32_t txS;             // Transmit timestamp as sent (host order)
+        uint32_t txF;
+        uint32_t sentMs;
+        uint8_t server;           // Index into _servers, NO_SERVER if not listed
+        RequestState state;       // LATE: abandoned, but a reply still updates stats
+    };
+    PendingRequest _requests[MAX_PENDING_REQUESTS];
+    
+    // Outgoing request, built once from NTP_REQUEST; each send only
+    // rewrites the transmit timestamp
+    static constexpr NTPRequestTemplate NTP_REQUEST{};
+    uint8_t _requestPacket[NTP_PACKET_SIZE];
+    
+    // Internal methods
+    SyncResult attemptSync(const char* hostname, uint32_t waitMs, uint32_t deadlineMs);
+    SyncResult syncTimeHedged(uint8_t primary, uint8_t secondary, uint32_t waitMs, uint32_t deadlineMs,
+                              bool& hedged);
+    void failSync(SyncResult& result, const char* hostname, SyncError error, uint32_t detail = 0);
+    void completeSync(SyncResult& result, const char* hostname, uint8_t slot,
+                      const NTPPacketView& reply, uint32_t startTime);
+    uint8_t findHedgeServer(uint8_t primary, uint16_t tried) const;
+    int8_t sendNTPPacket(const char* address, uint16_t port, uint8_t serverIndex);
+    int8_t receiveNTPPacket(uint8_t (&buffer)[NTP_PACKET_SIZE], uint32_t timeoutMs);
+    int8_t matchRequest(const NTPPacketView& reply) const;
+    void abandonRequests();
+    void drainLateReplies();
+    void creditLateReply(uint8_t slot, const NTPPacketView& reply);
+    void clearPendingRequests();
+    uint8_t findServer(const char* hostname, uint16_t port = 0) const;  // NO_SERVER if absent
+    void updateServerStats(NTPServer& server, bool success, int32_t offset, uint16_t rtt);
+    void scheduleAllPolls();
+    void schedulePoll(uint8_t index, uint32_t delaySeconds);
+    void catchUpPollWheel();
+    void scheduleProbe(uint8_t index);
+    uint32_t firstSyncDelay();
+    void pollServer(uint8_t index);
+    void autoSync();
+    void probeServer(uint8_t index);
+    void updateNextAction();
+};
+
+// The default client: NTP_UDP_CLASS transport, up to 10 servers
+using NTPClient = BasicNTPClient<NTP_UDP_CLASS>;
+
+#include "NTPClientImpl.h"
+
 // No global instance - create your own:
 // NTPClient ntp;
 
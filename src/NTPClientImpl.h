@@ -0,0 +1,987 @@
+#ifndef NTP_CLIENT_IMPL_H
+#define NTP_CLIENT_IMPL_H
+
+// Out-of-line members of BasicNTPClient, included from NTPClient.h
+
+#include <sys/time.h>
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+BasicNTPClient<Udp, MaxServers, Clock>::BasicNTPClient()
+    : _serverCount(0),
+      _pollWheelMs(0),
+      _pollWheelTick(0),
+      _pollWheelAdvancing(false),
+      _nextActionMs(0),
+      _actionPending(false),
+      _requests() {
+    memcpy(_requestPacket, NTP_REQUEST.bytes, sizeof(_requestPacket));
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::begin(uint16_t localPort) {
+    _localPort = localPort;
+    _udp.begin(_localPort);
+    _initialized = true;
+    
+    NTP_LOG_I("NTP Client initialized on port %d", _localPort);
+    
+    if (_serverCount == 0) {
+        NTP_LOG_W("No NTP servers configured. Add servers or use beginWithDefaults()");
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::beginWithDefaults(uint16_t localPort) {
+    // Add default servers before initialization
+    if (_serverCount == 0) {
+        NTP_LOG_I("Adding default NTP servers");
+        for (uint8_t i = 0; i < DEFAULT_SERVER_COUNT; i++) {
+            (void)addServer(DEFAULT_NTP_SERVERS[i]);
+        }
+    }
+    
+    // Initialize normally
+    begin(localPort);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::end() {
+    _udp.stop();
+    _initialized = false;
+    NTP_LOG_I("NTP Client stopped");
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+bool BasicNTPClient<Udp, MaxServers, Clock>::addServer(const char* hostname, uint16_t port) {
+    // Allow adding servers before begin() for pre-configuration
+    if (_serverCount >= MAX_SERVERS) {
+        NTP_LOG_E("Maximum number of servers (%d) reached", MAX_SERVERS);
+        return false;
+    }
+    
+    size_t length = strlen(hostname);
+    if (length == 0 || length > MAX_HOSTNAME_LENGTH) {
+        NTP_LOG_E("Invalid server hostname length %d (max %d)", (int)length, MAX_HOSTNAME_LENGTH);
+        return false;
+    }
+    
+    // Check if already exists
+    if (findServer(hostname, port) != NO_SERVER) {
+        NTP_LOG_D("Server %s:%d already exists, skipping", hostname, port);
+        return true;  // Not an error, server is available
+    }
+    
+    NTPServer& server = _servers[_serverCount];
+    memset(&server, 0, sizeof(server));
+    memcpy(server.hostname, hostname, length + 1);
+    server.port = port;
+    server.reachable = true;
+    server.stratum = 255;
+    server.rto = NTPServer::INITIAL_RTO_MS;
+    _serverCount++;
+    
+    // Until now auto-sync had nothing to sync from: start it through the
+    // same jittered first-sync phase as setAutoSync(), not immediately
+    if (_autoSyncEnabled) {
+        if (_serverCount == 1) {
+            schedulePoll(SYNC_ENTRY, firstSyncDelay());
+        }
+        scheduleProbe(_serverCount - 1);
+    }
+    
+    NTP_LOG_I("Added NTP server %s:%d", hostname, port);
+    return true;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+bool BasicNTPClient<Udp, MaxServers, Clock>::removeServer(const char* hostname) {
+    // Compact the table in place, keeping the order of the remaining servers
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        if (strcmp(_servers[i].hostname, hostname) != 0) {
+            if (kept != i) {
+                _servers[kept] = _servers[i];
+            }
+            kept++;
+        }
+    }
+    
+    if (kept != _serverCount) {
+        _serverCount = kept;
+        clearPendingRequests();  // Server indices shifted
+        scheduleAllPolls();      // So did the probe entries; rebuild the schedule
+        NTP_LOG_I("Removed NTP server %s", hostname);
+        return true;
+    }
+    
+    NTP_LOG_W("Server %s not found", hostname);
+    return false;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::clearServers() {
+    _serverCount = 0;
+    clearPendingRequests();
+    scheduleAllPolls();
+    NTP_LOG_I("Cleared all NTP servers");
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+uint8_t BasicNTPClient<Udp, MaxServers, Clock>::findServer(const char* hostname, uint16_t port) const {
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        if ((port == 0 || _servers[i].port == port) && strcmp(_servers[i].hostname, hostname) == 0) {
+            return i;
+        }
+    }
+    return NO_SERVER;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+NTPClientBase::NTPServer* BasicNTPClient<Udp, MaxServers, Clock>::getBestServer() {
+    NTPServer* best = nullptr;
+    uint32_t bestScore = UINT32_MAX;
+    uint32_t nowMs = Clock::millis();
+    
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        NTPServer& server = _servers[i];
+        if (!server.usable(nowMs)) continue;
+        
+        uint32_t score = server.score();
+        if (score < bestScore) {
+            bestScore = score;
+            best = &server;
+        }
+    }
+    
+    return best;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+bool BasicNTPClient<Udp, MaxServers, Clock>::setServerPollInterval(const char* hostname, uint32_t intervalSeconds) {
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        if (strcmp(_servers[i].hostname, hostname) == 0) {
+            _servers[i].pollInterval = intervalSeconds ? max(intervalSeconds, MIN_SYNC_INTERVAL) : 0;
+            if (_servers[i].reachable && !_servers[i].denied) {
+                _pollWheel.cancel(i);
+                scheduleProbe(i);
+            }
+            NTP_LOG_I("Poll interval for %s set to %lu seconds",
+                      hostname, _servers[i].pollInterval);
+            return true;
+        }
+    }
+    
+    NTP_LOG_W("Server %s not found", hostname);
+    return false;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::clearPendingRequests() {
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        _requests[i].state = REQUEST_IDLE;
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+uint8_t BasicNTPClient<Udp, MaxServers, Clock>::findHedgeServer(uint8_t primary, uint16_t tried) const {
+    uint8_t hedge = NO_SERVER;
+    uint32_t bestScore = UINT32_MAX;
+    uint32_t nowMs = Clock::millis();
+    
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        if (i == primary || !_servers[i].usable(nowMs) || (tried & (1U << i))) continue;
+        
+        uint32_t score = _servers[i].score();
+        if (score < bestScore) {
+            bestScore = score;
+            hedge = i;
+        }
+    }
+    
+    return hedge;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+NTPClientBase::SyncResult BasicNTPClient<Udp, MaxServers, Clock>::syncTime(uint32_t timeoutMs) {
+    static SyncResult result; // Use static to avoid stack corruption on return
+    result = SyncResult();    // Clear it
+    
+    if (!_initialized) {
+        result.error = SyncError::NOT_INITIALIZED;
+        return result;
+    }
+    
+    // timeoutMs is a total budget. Each attempt gets a share of what is
+    // left, so time a fast failure did not use rolls over to later servers.
+    uint32_t startTime = Clock::millis();
+    uint16_t tried = 0;  // Bit per server index, so no server is asked twice
+    
+    uint8_t candidates = 0;
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        if (_servers[i].usable(startTime)) candidates++;
+    }
+    
+    NTPServer* bestServer = getBestServer();
+    bool deadlineHit = false;
+    
+    for (uint8_t attempt = 0; attempt < candidates; attempt++) {
+        // Best server first, then the remaining reachable servers in order
+        uint8_t index = 0;
+        if (attempt == 0 && bestServer) {
+            index = bestServer - &_servers[0];
+        } else {
+            while (index < _serverCount &&
+                   (!_servers[index].usable(startTime) || (tried & (1U << index)))) {
+                index++;
+            }
+            if (index >= _serverCount) break;
+        }
+        tried |= 1U << index;
+        
+        uint32_t elapsed = Clock::millis() - startTime;
+        if (elapsed >= timeoutMs) {
+            deadlineHit = true;
+            break;
+        }
+        uint32_t remaining = timeoutMs - elapsed;
+        uint8_t left = candidates - attempt;
+        
+        // The best server usually answers; give it half the budget when
+        // there are fallbacks, then split the rest evenly
+        uint32_t slice = (attempt == 0 && left > 1) ? remaining / 2 : remaining / left;
+        
+        // Give up after the server's RTO while there is somewhere to fail
+        // over to; the last candidate may use everything that is left
+        uint32_t waitMs = (left > 1) ? min(slice, (uint32_t)_servers[index].rto) : remaining;
+        
+        // Hedge the first attempt to the runner-up if the best server is slow
+        uint8_t hedge = (_hedgingEnabled && attempt == 0 && left > 1)
+                        ? findHedgeServer(index, tried) : NO_SERVER;
+        if (hedge != NO_SERVER) {
+            bool hedged = false;
+            result = syncTimeHedged(index, hedge, slice, startTime + timeoutMs, hedged);
+            if (hedged) {
+                tried |= 1U << hedge;
+                attempt++;  // The runner-up has had its turn
+            }
+        } else {
+            result = attemptSync(_servers[index].hostname, waitMs, startTime + timeoutMs);
+        }
+        if (result.success) {
+            return result;
+        }
+        if (result.error == SyncError::DEADLINE_EXCEEDED) {
+            deadlineHit = true;  // The send itself used up the budget
+            break;
+        }
+    }
+    
+    _syncFailures++;
+    result.success = false;
+    result.error = deadlineHit ? SyncError::DEADLINE_EXCEEDED : SyncError::ALL_SERVERS_FAILED;
+    return result;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+NTPClientBase::SyncResult BasicNTPClient<Udp, MaxServers, Clock>::syncTimeFromServer(const char* hostname, uint32_t timeoutMs) {
+    return attemptSync(hostname, timeoutMs, Clock::millis() + timeoutMs);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+NTPClientBase::SyncResult BasicNTPClient<Udp, MaxServers, Clock>::attemptSync(const char* hostname, uint32_t waitMs,
+                                                                       uint32_t deadlineMs) {
+    static SyncResult result; // Use static to avoid stack corruption on return
+    result = SyncResult();    // Clear it
+    
+    uint32_t startTime = Clock::millis();
+    
+    NTP_LOG_D("Attempting sync with %s", hostname);
+    
+    // Find server in list; unlisted hosts are queried on the default port
+    result.serverIndex = findServer(hostname);
+    uint16_t port = result.serverIndex != NO_SERVER ? _servers[result.serverIndex].port
+                                                    : DEFAULT_NTP_PORT;
+    
+    // Send NTP request
+    if (sendNTPPacket(hostname, port, result.serverIndex) < 0) {
+        failSync(result, hostname, SyncError::SEND_FAILED);
+        return result;
+    }
+    
+    // The send may have blocked on DNS; only wait for what is left
+    int32_t leftMs = (int32_t)(deadlineMs - Clock::millis());
+    if (leftMs <= 0) {
+        abandonRequests();  // Not the server's fault; a late reply still counts
+        result.error = SyncError::DEADLINE_EXCEEDED;
+        NTP_LOG_W("Sync budget spent sending to %s", hostname);
+        return result;
+    }
+    
+    // Receive response
+    uint8_t buffer[NTP_PACKET_SIZE];
+    int8_t slot = receiveNTPPacket(buffer, min(waitMs, (uint32_t)leftMs));
+    if (slot < 0) {
+        abandonRequests();
+        failSync(result, hostname, SyncError::TIMEOUT);
+        return result;
+    }
+    
+    completeSync(result, hostname, slot, NTPPacketView(buffer), startTime);
+    return result;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+NTPClientBase::SyncResult BasicNTPClient<Udp, MaxServers, Clock>::syncTimeHedged(uint8_t primary, uint8_t secondary,
+                                                                          uint32_t waitMs, uint32_t deadlineMs,
+                                                                          bool& hedged) {
+    static SyncResult result; // Use static to avoid stack corruption on return
+    result = SyncResult();    // Clear it
+    result.serverIndex = primary;
+    hedged = false;
+    
+    uint32_t startTime = Clock::millis();
+    
+    // This attempt ends after waitMs, and never after the sync's deadline
+    uint32_t endMs = startTime + waitMs;
+    if ((int32_t)(deadlineMs - endMs) < 0) {
+        endMs = deadlineMs;
+    }
+    
+    if (sendNTPPacket(_servers[primary].hostname, _servers[primary].port, primary) < 0) {
+        failSync(result, _servers[primary].hostname, SyncError::SEND_FAILED);
+        return result;
+    }
+    
+    // As in attemptSync(), the send may have blocked on DNS; that time is
+    // not the server's fault and is not charged to it
+    int32_t leftMs = (int32_t)(endMs - Clock::millis());
+    if (leftMs <= 0) {
+        abandonRequests();
+        result.error = (int32_t)(deadlineMs - Clock::millis()) <= 0 ? SyncError::DEADLINE_EXCEEDED
+                                                                     : SyncError::TIMEOUT;
+        NTP_LOG_W("Sync budget spent sending to %s", _servers[primary].hostname);
+        return result;
+    }
+    
+    // Usually the best server answers within its p95 RTT. If not, ask the
+    // runner-up on the same socket and take whichever reply comes first;
+    // both requests stay open until one of them wins.
+    uint8_t buffer[NTP_PACKET_SIZE];
+    uint32_t hedgeAfterMs = min((uint32_t)_servers[primary].rttP95(), (uint32_t)leftMs);
+    int8_t slot = receiveNTPPacket(buffer, hedgeAfterMs);
+    bool waitedForHedge = false;
+    
+    if (slot < 0 && (int32_t)(endMs - Clock::millis()) > 0) {
+        NTP_LOG_D("No reply from %s within %lums, hedging to %s",
+                  _servers[primary].hostname, hedgeAfterMs,
+                  _servers[secondary].hostname);
+        hedged = sendNTPPacket(_servers[secondary].hostname, _servers[secondary].port,
+                               secondary) >= 0;
+        
+        // The hedge's DNS lookup may have used up the rest of the time
+        leftMs = (int32_t)(endMs - Clock::millis());
+        if (hedged && leftMs > 0) {
+            waitedForHedge = true;
+        }
+        if (leftMs > 0) {
+            slot = receiveNTPPacket(buffer, (uint32_t)leftMs);
+        }
+    }
+    
+    if (slot < 0) {
+        abandonRequests();
+        failSync(result, _servers[primary].hostname, SyncError::TIMEOUT);
+        if (waitedForHedge) {
+            // syncTime() does not ask the runner-up again, so charge it here
+            updateServerStats(_servers[secondary], false, 0, 0);
+        }
+        return result;
+    }
+    
+    // completeSync() marks the loser late; its reply still updates its stats
+    result.serverIndex = _requests[slot].server;
+    completeSync(result, _servers[result.serverIndex].hostname, slot, NTPPacketView(buffer), startTime);
+    return result;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::failSync(SyncResult& result, const char* hostname,
+                                               SyncError error, uint32_t detail) {
+    result.error = error;
+    result.errorDetail = detail;
+    
+    char reason[40];
+    NTP_LOG_SYNC_FAILED(hostname, result.toString(reason, sizeof(reason)));
+    (void)reason;  // Unused when logging is compiled out
+    
+    // A kiss is an answer, not a lost reply; handleKissOfDeath() has
+    // already backed off or demoted the server
+    if (result.serverIndex < _serverCount && error != SyncError::KISS_OF_DEATH) {
+        updateServerStats(_servers[result.serverIndex], false, 0, 0);
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::completeSync(SyncResult& result, const char* hostname, uint8_t slot,
+                                                   const NTPPacketView& reply, uint32_t startTime) {
+    NTPServer* serverInfo = result.serverIndex < _serverCount ? &_servers[result.serverIndex] : nullptr;
+    // Parse response - now returns BOTH seconds and microseconds
+    // RTT is measured from the moment the request left, excluding DNS lookup
+    uint16_t rtt = Clock::millis() - _requests[slot].sentMs;
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (_requests[i].state == REQUEST_WAITING) {
+            _requests[i].state = REQUEST_LATE;  // Losing hedge, credited if it answers
+        }
+    }
+    _requests[slot].state = REQUEST_IDLE;
+    uint32_t ntpUsec = 0;
+    uint32_t kissCode = 0;
+    time_t ntpTime = parseNTPPacket(reply, rtt, ntpUsec, kissCode);
+
+    if (kissCode != 0) {
+        if (serverInfo) {
+            handleKissOfDeath(*serverInfo, kissCode, Clock::millis());
+        }
+        failSync(result, hostname, SyncError::KISS_OF_DEATH, kissCode);
+        return;
+    }
+
+    if (ntpTime == 0) {
+        failSync(result, hostname, SyncError::INVALID_PACKET);
+        return;
+    }
+
+    int32_t offset = offsetFromSystemMs(ntpTime, ntpUsec);
+
+    // Apply time with microsecond precision
+    applyTimeOffset(ntpTime, ntpUsec);
+
+    // Update result
+    result.success = true;
+    result.offsetMs = offset;
+    result.syncUsec = ntpUsec;
+    result.roundTripMs = rtt;
+    result.stratum = reply.stratum();
+    NTP_LOG_D("Setting result.syncTime to ntpTime=%ld.%06lu", ntpTime, ntpUsec);
+    result.syncTime = ntpTime;
+    NTP_LOG_D("Verify: result.syncTime=%ld, syncUsec=%lu", result.syncTime, result.syncUsec);
+    
+    // Update statistics
+    _syncCount++;
+    _lastSyncTime = ntpTime;
+    _lastOffset = offset;
+    
+    uint32_t syncTime = Clock::millis() - startTime;
+    _totalSyncTime += syncTime;
+    _averageSyncTime = (float)_totalSyncTime / _syncCount;
+    
+    if (serverInfo) {
+        updateServerStats(*serverInfo, true, offset, rtt);
+        serverInfo->stratum = reply.stratum();
+    }
+    
+    // Any successful sync, manual or automatic, restarts the interval
+    if (_autoSyncEnabled) {
+        schedulePoll(SYNC_ENTRY, jitteredInterval(_autoSyncInterval));
+    }
+    
+    NTP_LOG_SYNC_SUCCESS(hostname, offset);
+    NTP_LOG_SERVER_STATS(hostname, rtt, offset);
+    
+    // Trigger callbacks (or queue them in deferred mode)
+    notifySync(result);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+bool BasicNTPClient<Udp, MaxServers, Clock>::forceSync() {
+    NTP_LOG_I("Forcing time sync");
+    SyncResult result = syncTime();
+    return result.success;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::setAutoSync(bool enable, uint32_t intervalSeconds) {
+    _autoSyncEnabled = enable;
+    _autoSyncInterval = max(intervalSeconds, MIN_SYNC_INTERVAL);
+    
+    // Disabled, only the re-probes of unreachable servers stay armed
+    scheduleAllPolls();
+    
+    NTP_LOG_I("Auto-sync %s (interval: %d seconds)", 
+              enable ? "enabled" : "disabled", _autoSyncInterval);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+time_t BasicNTPClient<Udp, MaxServers, Clock>::getNextSyncTime() const {
+    if (!_autoSyncEnabled || !_pollWheel.isArmed(SYNC_ENTRY)) {
+        return 0;
+    }
+    
+    // Sync deadline, converted from wheel ticks to epoch
+    uint32_t nextDue = _pollWheel.dueTick(SYNC_ENTRY) - _pollWheelTick;
+    uint32_t pendingSeconds = (Clock::millis() - _pollWheelMs) / 1000;
+    return time(nullptr) + (nextDue > pendingSeconds ? nextDue - pendingSeconds : 0);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::printDiagnostics() {
+    NTP_LOG_I("=== NTP Client Diagnostics ===");
+    NTP_LOG_I("Status: %s", _initialized ? "Initialized" : "Not initialized");
+    NTP_LOG_I("Auto-sync: %s (interval: %ds)", 
+              _autoSyncEnabled ? "ON" : "OFF", _autoSyncInterval);
+    NTP_LOG_I("Current time: %s", getFormattedDateTime());
+    NTP_LOG_I("Time zone: %s (UTC%+d)", 
+              _zone.name(), _zone.config().offsetMinutes / 60);
+    NTP_LOG_I("DST: %s", isDST() ? "Active" : "Inactive");
+    String lastSyncStr = _lastSyncTime ? epochToString(_lastSyncTime) : "Never";
+    NTP_LOG_I("Last sync: %s", lastSyncStr.c_str());
+    NTP_LOG_I("Last offset: %ldms", _lastOffset);
+    NTP_LOG_I("Sync count: %d (failures: %d)", _syncCount, _syncFailures);
+    NTP_LOG_I("Average sync time: %.1fms", _averageSyncTime);
+    if (_pollWheel.isArmed(SYNC_ENTRY)) {
+        NTP_LOG_I("Next sync in %lus", _pollWheel.dueTick(SYNC_ENTRY) - _pollWheelTick);
+    }
+    
+    NTP_LOG_I("\nServers (%d):", _serverCount);
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        const NTPServer& server = _servers[i];
+        NTP_LOG_I("  %s:%d - Stratum %d, RTT %dms, Offset %ldms, Poll %lus, %s",
+                  server.hostname, server.port,
+                  server.stratum, server.averageRTT, server.averageOffset,
+                  server.pollInterval,
+                  server.denied ? "DENIED" : server.reachable ? "OK" : "UNREACHABLE");
+        NTP_LOG_I("    reach %03o%s", server.reach,
+                  server.reachable || server.denied ? "" : ", re-probing with backoff");
+        if (server.kissCode != 0) {
+            char code[5];
+            kissCodeToString(server.kissCode, code);
+            NTP_LOG_I("    last kiss code %s, rate backoff x%d", code, 1 << server.rateBackoff);
+        }
+        if (_pollWheel.isArmed(i)) {
+            NTP_LOG_I("    next probe in %lus", _pollWheel.dueTick(i) - _pollWheelTick);
+        }
+    }
+    
+    NTP_LOG_I("==============================");
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::resetStatistics() {
+    _syncCount = 0;
+    _syncFailures = 0;
+    _averageSyncTime = 0;
+    _totalSyncTime = 0;
+    
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        NTPServer& server = _servers[i];
+        server.failureCount = 0;
+        server.averageOffset = 0;
+        server.averageRTT = 0;
+        server.reachable = true;
+        server.srtt = 0;
+        server.rttVar = 0;
+        server.rto = NTPServer::INITIAL_RTO_MS;
+        server.reach = 0;
+        server.reprobeInterval = 0;
+    }
+    
+    NTP_LOG_I("Statistics reset");
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::process() {
+    // Deliver callbacks deferred by syncs outside process()
+    bool dispatch = _deferCallbacks && _dispatchFromProcess;
+    if (dispatch && hasPendingCallbacks()) {
+        dispatchPendingCallbacks();
+    }
+    
+    // Fast path: nothing is due yet
+    if (!_actionPending || (int32_t)(Clock::millis() - _nextActionMs) < 0) return;
+    if (!_initialized) return;
+    
+    // Advance the poll wheel by whole seconds elapsed; each tick is O(1)
+    uint32_t elapsedTicks = (Clock::millis() - _pollWheelMs) / 1000;
+    if (elapsedTicks == 0) return;
+    _pollWheelMs += elapsedTicks * 1000;
+    _pollWheelTick += elapsedTicks;
+    
+    // Polls re-armed from inside advance() are anchored at _pollWheelTick,
+    // never behind the tick being drained, and leave the wheel in place
+    _pollWheelAdvancing = true;
+    _pollWheel.advance(_pollWheelTick, [this](uint8_t index) {
+        pollServer(index);
+    });
+    _pollWheelAdvancing = false;
+    
+    updateNextAction();
+    
+    // Polls above ran with their callbacks queued; deliver them now
+    if (dispatch) {
+        dispatchPendingCallbacks();
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+uint32_t BasicNTPClient<Udp, MaxServers, Clock>::getMillisUntilNextAction() const {
+    if (_deferCallbacks && _dispatchFromProcess && hasPendingCallbacks()) {
+        return 0;  // process() has callbacks to deliver
+    }
+    if (!_initialized || !_actionPending) {
+        return NO_PENDING_ACTION;
+    }
+    
+    int32_t remaining = (int32_t)(_nextActionMs - Clock::millis());
+    return remaining > 0 ? (uint32_t)remaining : 0;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::updateNextAction() {
+    uint32_t ticks;
+    _actionPending = _pollWheel.ticksUntilNext(ticks);
+    if (_actionPending) {
+        // Measured from the anchor; the wheel may still be mid-advance
+        int32_t fromAnchor = (int32_t)(_pollWheel.now() + ticks - _pollWheelTick);
+        _nextActionMs = _pollWheelMs + (fromAnchor > 0 ? (uint32_t)fromAnchor * 1000 : 0);
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::scheduleAllPolls() {
+    // Cancelled entry by entry: this may run from a callback inside advance()
+    for (uint8_t i = 0; i <= SYNC_ENTRY; i++) {
+        _pollWheel.cancel(i);
+    }
+    
+    if (_autoSyncEnabled) {
+        schedulePoll(SYNC_ENTRY, firstSyncDelay());
+    }
+    for (uint8_t i = 0; i < _serverCount; i++) {
+        scheduleProbe(i);
+    }
+    updateNextAction();
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::scheduleProbe(uint8_t index) {
+    const NTPServer& server = _servers[index];
+    if (server.denied) return;  // DENY/RSTR: never polled again
+    
+    if (!server.reachable) {
+        schedulePoll(index, jitteredInterval(server.reprobeInterval));
+    } else if (_autoSyncEnabled && server.pollInterval > 0) {
+        // Spread probes across the interval rather than bursting with the sync
+        schedulePoll(index, nextJitterRandom() % server.pollInterval);
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+uint32_t BasicNTPClient<Udp, MaxServers, Clock>::firstSyncDelay() {
+    // Once the clock is set, the next sync is due an interval after the last
+    if (_lastSyncTime != 0) {
+        time_t age = time(nullptr) - _lastSyncTime;
+        if (age >= 0 && (uint32_t)age < _autoSyncInterval) {
+            return jitteredInterval(_autoSyncInterval - (uint32_t)age);
+        }
+    }
+    
+    // Per-device phase for the first sync, so devices powered up together
+    // do not all hit the server in the same second
+    return _firstSyncSpread > 0 ? nextJitterRandom() % (_firstSyncSpread + 1) : 0;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::schedulePoll(uint8_t index, uint32_t delaySeconds) {
+    // An idle wheel jumps to the present instead of stepping through the
+    // gap in process(), but never while advance() is draining it
+    if (_pollWheel.armedCount() == 0 && !_pollWheelAdvancing) {
+        catchUpPollWheel();
+        _pollWheel.reset(_pollWheelTick);
+    }
+    
+    // The wheel only advances in process(); account for time since then
+    uint32_t lagTicks = (Clock::millis() - _pollWheelMs) / 1000;
+    _pollWheel.schedule(index, _pollWheelTick + lagTicks + delaySeconds);
+    updateNextAction();
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::catchUpPollWheel() {
+    uint32_t lagTicks = (Clock::millis() - _pollWheelMs) / 1000;
+    _pollWheelMs += lagTicks * 1000;
+    _pollWheelTick += lagTicks;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::pollServer(uint8_t index) {
+    if (index == SYNC_ENTRY) {
+        autoSync();
+    } else if (index < _serverCount && !_servers[index].denied) {
+        probeServer(index);
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::autoSync() {
+    if (!_autoSyncEnabled) return;
+    
+    // One clock-setting sync per interval; syncTime() fails over across
+    // servers and skips those that are unreachable or rate limited.
+    // Success re-arms SYNC_ENTRY in completeSync().
+    NTP_LOG_D("Auto-sync");
+    SyncResult result = syncTime(_syncTimeout);
+    if (result.success) return;
+    
+    // Until the clock has been set once, retry failures at the minimum interval
+    uint32_t nextSync = _lastSyncTime == 0 ? MIN_SYNC_INTERVAL : _autoSyncInterval;
+    schedulePoll(SYNC_ENTRY, jitteredInterval(nextSync));
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::probeServer(uint8_t index) {
+    NTPServer& server = _servers[index];
+    bool wasReachable = server.reachable;
+    if (wasReachable && !_autoSyncEnabled) return;  // Stale probe
+    
+    // Rate limited: come back when the holdoff ends, without a request
+    uint32_t nowMs = Clock::millis();
+    if (server.heldOff(nowMs)) {
+        schedulePoll(index, (server.holdoffUntilMs - nowMs + 999) / 1000);
+        return;
+    }
+    
+    // A probe only updates statistics; the clock is set by syncs
+    NTP_LOG_D("%s server %s", wasReachable ? "Probing" : "Re-probing unreachable",
+              server.hostname);
+    uint8_t buffer[NTP_PACKET_SIZE];
+    int8_t slot = sendNTPPacket(server.hostname, server.port, index);
+    if (slot >= 0 && (slot = receiveNTPPacket(buffer, server.rto)) >= 0) {
+        creditLateReply(slot, NTPPacketView(buffer));
+    } else {
+        abandonRequests();
+        updateServerStats(server, false, 0, 0);
+    }
+    
+    if (index >= _serverCount || server.denied) return;
+    
+    if (server.reachable) {
+        if (_autoSyncEnabled && server.pollInterval > 0) {
+            schedulePoll(index, jitteredInterval(server.pollInterval));
+        }
+        return;
+    }
+    
+    // Just marked unreachable: updateServerStats() armed the first re-probe
+    if (wasReachable) return;
+    
+    // Still down: back off exponentially up to the cap
+    server.reprobeInterval = min(server.reprobeInterval * 2, MAX_REPROBE_INTERVAL);
+    schedulePoll(index, jitteredInterval(server.reprobeInterval));
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+int8_t BasicNTPClient<Udp, MaxServers, Clock>::sendNTPPacket(const char* address, uint16_t port, uint8_t serverIndex) {
+    // Credit late replies still queued before their slot can be reused
+    drainLateReplies();
+    
+    // Prefer a free slot, then one only kept for a late reply
+    int8_t slot = 0;
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (_requests[i].state == REQUEST_IDLE) {
+            slot = i;
+            break;
+        }
+        if (_requests[i].state == REQUEST_LATE) {
+            slot = i;
+        }
+    }
+    PendingRequest& request = _requests[slot];
+    request.state = REQUEST_IDLE;
+    
+    NTP_LOG_I("Sending NTP request to %s", address);
+    
+    // Resolve and open the datagram first, so DNS time does not sit
+    // between the transmit timestamp and the wire
+    if (_udp.beginPacket(address, port) != 1) {
+        NTP_LOG_E("Failed to begin UDP packet to %s", address);
+        return -1;
+    }
+    
+    // Current time as transmit timestamp, patched into the prebuilt request.
+    // The server copies it into the reply's originate timestamp, which is
+    // how replies are matched to this request and stale ones discarded.
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    request.txS = now.tv_sec + NTP_TIMESTAMP_DELTA;
+    request.txF = (uint32_t)(((uint64_t)now.tv_usec << 32) / 1000000ULL);
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (i != slot && _requests[i].state != REQUEST_IDLE &&
+            _requests[i].txS == request.txS && _requests[i].txF == request.txF) {
+            request.txF++;  // Same microsecond as an open request; keep replies apart
+        }
+    }
+    NTPPacketView::putWord<NTPPacketView::TRANSMIT_TIMESTAMP>(_requestPacket, request.txS);
+    NTPPacketView::putWord<NTPPacketView::TRANSMIT_TIMESTAMP + 4>(_requestPacket, request.txF);
+    
+    _udp.write(_requestPacket, sizeof(_requestPacket));
+    
+    if (_udp.endPacket() != 1) {
+        NTP_LOG_E("Failed to send UDP packet to %s", address);
+        return -1;
+    }
+    request.sentMs = Clock::millis();
+    request.server = serverIndex;
+    request.state = REQUEST_WAITING;
+    
+    NTP_LOG_V("NTP packet sent to %s, transmit timestamp %lu.%08lX",
+              address, request.txS, request.txF);
+    return slot;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+int8_t BasicNTPClient<Udp, MaxServers, Clock>::matchRequest(const NTPPacketView& reply) const {
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (_requests[i].state != REQUEST_IDLE &&
+            reply.originSeconds() == _requests[i].txS && reply.originFraction() == _requests[i].txF) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+int8_t BasicNTPClient<Udp, MaxServers, Clock>::receiveNTPPacket(uint8_t (&buffer)[NTP_PACKET_SIZE],
+                                                         uint32_t timeoutMs) {
+    uint32_t startTime = Clock::millis();
+    
+    while ((Clock::millis() - startTime) < timeoutMs) {
+        int packetSize = _udp.parsePacket();
+        
+        if (packetSize >= NTP_PACKET_SIZE) {
+            _udp.read(buffer, NTP_PACKET_SIZE);
+            NTP_LOG_V("NTP packet received (size: %d)", packetSize);
+            
+            NTPPacketView reply(buffer);
+            int8_t slot = matchRequest(reply);
+            if (slot < 0) {
+                NTP_LOG_D("Discarding reply that does not match any outstanding request");
+                continue;
+            }
+            if (_requests[slot].state == REQUEST_LATE) {
+                creditLateReply(slot, reply);  // Answer to an earlier, abandoned request
+                continue;
+            }
+            
+            return slot;
+        }
+        
+        // Allow caller to yield control (e.g., for watchdog feeding)
+        if (_yieldCallback) {
+            _yieldCallback();
+        }
+        
+        // Small delay to prevent tight loop
+        Clock::delay(1);
+        yield();
+    }
+    
+    return -1;  // Requests stay WAITING; the caller decides when to give up
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::abandonRequests() {
+    // Keep listening for the abandoned requests so late replies update stats
+    for (uint8_t i = 0; i < MAX_PENDING_REQUESTS; i++) {
+        if (_requests[i].state == REQUEST_WAITING) {
+            _requests[i].state = REQUEST_LATE;
+        }
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::drainLateReplies() {
+    uint8_t buffer[NTP_PACKET_SIZE];
+    int packetSize;
+    
+    while ((packetSize = _udp.parsePacket()) > 0) {
+        if (packetSize < NTP_PACKET_SIZE) continue;
+        _udp.read(buffer, NTP_PACKET_SIZE);
+        
+        NTPPacketView reply(buffer);
+        int8_t slot = matchRequest(reply);
+        if (slot >= 0 && _requests[slot].state == REQUEST_LATE) {
+            creditLateReply(slot, reply);
+        }
+    }
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::creditLateReply(uint8_t slot, const NTPPacketView& reply) {
+    PendingRequest& request = _requests[slot];
+    request.state = REQUEST_IDLE;
+    if (request.server >= _serverCount) return;
+    
+    // The reply proves the server is alive and gives a valid RTT sample,
+    // but the clock has already been set from another reply
+    uint16_t rtt = Clock::millis() - request.sentMs;
+    uint32_t usec = 0;
+    uint32_t kissCode = 0;
+    time_t ntpTime = parseNTPPacket(reply, rtt, usec, kissCode);
+    NTPServer& server = _servers[request.server];
+    if (kissCode != 0) {
+        handleKissOfDeath(server, kissCode, Clock::millis());
+        return;
+    }
+    if (ntpTime == 0) return;
+    
+    updateServerStats(server, true, offsetFromSystemMs(ntpTime, usec), rtt);
+    server.stratum = reply.stratum();
+    NTP_LOG_D("Late reply from %s after %dms credited to its statistics",
+              server.hostname, rtt);
+}
+
+template <typename Udp, uint8_t MaxServers, typename Clock>
+void BasicNTPClient<Udp, MaxServers, Clock>::updateServerStats(NTPServer& server, bool success, int32_t offset, uint16_t rtt) {
+    // Reachability register: one bit per poll, newest in bit 0
+    server.reach = (uint8_t)((server.reach << 1) | (success ? 1 : 0));
+    
+    if (success) {
+        server.lastSuccessTime = time(nullptr);
+        server.failureCount = 0;
+        if (!server.reachable && !server.denied) {
+            server.reachable = true;
+            server.reprobeInterval = 0;
+            NTP_LOG_I("Server %s is reachable again", server.hostname);
+        }
+        server.updateRTO(rtt);
+        if (server.rateBackoff > 0) {
+            server.rateBackoff--;  // Ease back towards the configured poll rate
+        }
+        
+        // Update running averages (exponential moving average)
+        if (server.averageOffset == 0) {
+            server.averageOffset = offset;
+            server.averageRTT = rtt;
+        } else {
+            server.averageOffset = (int32_t)((1.0f - OFFSET_FILTER_ALPHA) * server.averageOffset + 
+                                            OFFSET_FILTER_ALPHA * offset);
+            server.averageRTT = (uint16_t)((1.0f - OFFSET_FILTER_ALPHA) * server.averageRTT + 
+                                          OFFSET_FILTER_ALPHA * rtt);
+        }
+    } else {
+        server.failureCount++;
+        server.backoffRTO();
+        
+        // Mark as unreachable after too many failures, and re-probe it in
+        // the background with exponential backoff until it answers again
+        if (server.failureCount >= MAX_RETRY_COUNT && server.reachable) {
+            server.reachable = false;
+            server.reprobeInterval = MIN_REPROBE_INTERVAL;
+            schedulePoll(&server - &_servers[0], jitteredInterval(server.reprobeInterval));
+            NTP_LOG_W("Server %s marked as unreachable, re-probing in %lus",
+                      server.hostname, server.reprobeInterval);
+        }
+    }
+}
+
+#endif // NTP_CLIENT_IMPL_H
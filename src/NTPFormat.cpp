@@ -0,0 +1,221 @@
+#include "NTPFormat.h"
+#include <string.h>
+
+static constexpr uint32_t POWERS_OF_TEN[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+static bool civilFor(int64_t utc, int16_t offsetMinutes, NTPCivilTime& civil) {
+    civil = NTPCalendar::fromEpoch(utc + offsetMinutes * 60L);
+    return civil.year >= 0 && civil.year <= 9999;
+}
+
+// Exactly `digits` decimal digits, advancing the cursor
+static bool parseDigits(const char*& p, const char* end, uint8_t digits, uint32_t& value) {
+    if (end - p < digits) return false;
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < digits; i++) {
+        if (p[i] < '0' || p[i] > '9') return false;
+        result = result * 10 + (p[i] - '0');
+    }
+    value = result;
+    p += digits;
+    return true;
+}
+
+static bool parseChar(const char*& p, const char* end, char c) {
+    if (p == end || *p != c) return false;
+    p++;
+    return true;
+}
+
+void NTPFormat::writeDateTime(const NTPCivilTime& civil, char* out) {
+    writePair(out, (uint8_t)(civil.year / 100));
+    writePair(out + 2, (uint8_t)(civil.year % 100));
+    out[4] = '-';
+    writePair(out + 5, civil.month);
+    out[7] = '-';
+    writePair(out + 8, civil.day);
+    out[10] = ' ';
+    writePair(out + 11, civil.hour);
+    out[13] = ':';
+    writePair(out + 14, civil.minute);
+    out[16] = ':';
+    writePair(out + 17, civil.second);
+}
+
+size_t NTPFormat::rfc3339(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                          uint8_t fractionDigits, char* buffer, size_t length) {
+    NTPCivilTime civil;
+    if (!civilFor(utc, offsetMinutes, civil)) return 0;
+
+    char dateTime[DATE_TIME_LENGTH];
+    writeDateTime(civil, dateTime);
+    return composeRFC3339(dateTime, nanos, offsetMinutes, fractionDigits, buffer, length);
+}
+
+size_t NTPFormat::format(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                         NTPTimeFormat format, char* buffer, size_t length) {
+    NTPCivilTime civil;
+    if (!civilFor(utc, offsetMinutes, civil)) return 0;
+
+    char dateTime[DATE_TIME_LENGTH];
+    writeDateTime(civil, dateTime);
+    return compose(dateTime, nanos, offsetMinutes, format, buffer, length);
+}
+
+size_t NTPFormat::compose(const char* dateTime, uint32_t nanos, int16_t offsetMinutes,
+                          NTPTimeFormat format, char* buffer, size_t length) {
+    const char* source;
+    size_t total;
+    switch (format) {
+        case NTPTimeFormat::TIME:           source = dateTime + 11; total = 8; break;
+        case NTPTimeFormat::DATE:           source = dateTime; total = 10; break;
+        case NTPTimeFormat::DATE_TIME:      source = dateTime; total = DATE_TIME_LENGTH; break;
+        case NTPTimeFormat::RFC3339:
+            return composeRFC3339(dateTime, nanos, offsetMinutes, 0, buffer, length);
+        case NTPTimeFormat::RFC3339_MILLIS:
+            return composeRFC3339(dateTime, nanos, offsetMinutes, 3, buffer, length);
+        case NTPTimeFormat::RFC3339_MICROS:
+            return composeRFC3339(dateTime, nanos, offsetMinutes, 6, buffer, length);
+        default:
+            return 0;
+    }
+
+    if (buffer == nullptr || length <= total) return 0;
+    memcpy(buffer, source, total);
+    buffer[total] = '\0';
+    return total;
+}
+
+size_t NTPFormat::composeRFC3339(const char* dateTime, uint32_t nanos, int16_t offsetMinutes,
+                                 uint8_t fractionDigits, char* buffer, size_t length) {
+    if (fractionDigits > MAX_FRACTION_DIGITS) fractionDigits = MAX_FRACTION_DIGITS;
+    if (nanos > 999999999) nanos = 999999999;
+
+    size_t total = DATE_TIME_LENGTH + (fractionDigits ? 1 + fractionDigits : 0) +
+                   (offsetMinutes ? 6 : 1);
+    if (buffer == nullptr || length <= total) return 0;
+    if (offsetMinutes <= -100 * 60 || offsetMinutes >= 100 * 60) return 0;
+
+    char* p = buffer;
+    memcpy(p, dateTime, DATE_TIME_LENGTH);
+    p[10] = 'T';
+    p += DATE_TIME_LENGTH;
+
+    if (fractionDigits) {
+        *p++ = '.';
+        writeDigits(p, nanos / POWERS_OF_TEN[MAX_FRACTION_DIGITS - fractionDigits], fractionDigits);
+        p += fractionDigits;
+    }
+
+    if (offsetMinutes == 0) {
+        *p++ = 'Z';
+    } else {
+        uint16_t magnitude = offsetMinutes < 0 ? -offsetMinutes : offsetMinutes;
+        p[0] = offsetMinutes < 0 ? '-' : '+';
+        writePair(p + 1, (uint8_t)(magnitude / 60));
+        p[3] = ':';
+        writePair(p + 4, (uint8_t)(magnitude % 60));
+        p += 6;
+    }
+    *p = '\0';
+    return total;
+}
+
+size_t NTPFormatMemo::format(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                             NTPTimeFormat format, char* buffer, size_t length) {
+    int64_t local = utc + offsetMinutes * 60L;
+    if (local != _local && !advance(local)) {
+        if (!civilFor(utc, offsetMinutes, _civil)) {
+            _local = INT64_MIN;
+            return 0;
+        }
+        NTPFormat::writeDateTime(_civil, _text);
+        _local = local;
+    }
+    return NTPFormat::compose(_text, nanos, offsetMinutes, format, buffer, length);
+}
+
+// Step the cached time forward to `local` if that stays within the same
+// day; false if a full conversion is needed
+bool NTPFormatMemo::advance(int64_t local) {
+    if (_local == INT64_MIN || local < _local) return false;
+    int64_t seconds = _civil.second + (local - _local);
+    if (seconds >= 60) {
+        int64_t minutes = _civil.minute + seconds / 60;
+        if (minutes >= 60) {
+            int64_t hours = _civil.hour + minutes / 60;
+            if (hours >= 24) return false;
+            _civil.hour = (uint8_t)hours;
+            NTPFormat::writePair(_text + 11, _civil.hour);
+        }
+        _civil.minute = (uint8_t)(minutes % 60);
+        NTPFormat::writePair(_text + 14, _civil.minute);
+    }
+    _civil.second = (uint8_t)(seconds % 60);
+    NTPFormat::writePair(_text + 17, _civil.second);
+    _local = local;
+    return true;
+}
+
+bool NTPFormat::parseRFC3339(const char* text, int64_t& utc, uint32_t& nanos) {
+    return text != nullptr && parseRFC3339(text, strlen(text), utc, nanos);
+}
+
+bool NTPFormat::parseRFC3339(const char* text, size_t length, int64_t& utc, uint32_t& nanos) {
+    if (text == nullptr) return false;
+    const char* p = text;
+    const char* end = text + length;
+
+    uint32_t year, month, day;
+    if (!parseDigits(p, end, 4, year) || !parseChar(p, end, '-') ||
+        !parseDigits(p, end, 2, month) || !parseChar(p, end, '-') ||
+        !parseDigits(p, end, 2, day)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > NTPCalendar::daysInMonth(year, month)) {
+        return false;
+    }
+
+    uint32_t hour = 0, minute = 0, second = 0, fraction = 0;
+    int32_t offsetMinutes = 0;
+    if (p != end) {
+        if (*p != 'T' && *p != 't' && *p != ' ') return false;
+        p++;
+        if (!parseDigits(p, end, 2, hour) || !parseChar(p, end, ':') ||
+            !parseDigits(p, end, 2, minute)) {
+            return false;
+        }
+        if (parseChar(p, end, ':')) {
+            if (!parseDigits(p, end, 2, second)) return false;
+            if (p != end && (*p == '.' || *p == ',')) {
+                const char* digits = ++p;
+                uint32_t scale = 100000000;
+                for (; p != end && *p >= '0' && *p <= '9'; p++) {
+                    fraction += (*p - '0') * scale;
+                    scale /= 10;
+                }
+                if (p == digits) return false;
+            }
+        }
+        if (hour > 23 || minute > 59 || second > 60) return false;
+
+        if (p != end && (*p == 'Z' || *p == 'z')) {
+            p++;
+        } else if (p != end && (*p == '+' || *p == '-')) {
+            int32_t sign = *p++ == '-' ? -1 : 1;
+            uint32_t offsetHours, offsetMins;
+            if (!parseDigits(p, end, 2, offsetHours)) return false;
+            parseChar(p, end, ':');
+            if (!parseDigits(p, end, 2, offsetMins)) return false;
+            if (offsetHours > 23 || offsetMins > 59) return false;
+            offsetMinutes = sign * (int32_t)(offsetHours * 60 + offsetMins);
+        }
+    }
+    if (p != end) return false;
+
+    utc = NTPCalendar::toEpoch(year, month, day, hour, minute, second) - offsetMinutes * 60L;
+    nanos = fraction;
+    return true;
+}
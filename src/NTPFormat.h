@@ -0,0 +1,335 @@
+#ifndef NTP_FORMAT_H
+#define NTP_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <utility>
+#include "NTPCalendar.h"
+
+// Fixed timestamp layouts, all slices of "YYYY-MM-DD HH:MM:SS" plus an
+// optional fraction and UTC offset
+enum class NTPTimeFormat : uint8_t {
+    TIME,           // "14:30:45"
+    DATE,           // "2024-01-15"
+    DATE_TIME,      // "2024-01-15 14:30:45"
+    RFC3339,        // "2024-01-15T14:30:45+01:00"
+    RFC3339_MILLIS, // "2024-01-15T14:30:45.123+01:00"
+    RFC3339_MICROS  // "2024-01-15T14:30:45.123456+01:00"
+};
+
+/**
+ * Locale-free timestamp formatting into caller buffers. Numbers are written
+ * two digits at a time from a 200-byte pair table, so a full RFC 3339
+ * timestamp costs one calendar conversion and about a dozen table copies
+ * instead of a strftime() pass over the format string.
+ */
+class NTPFormat {
+public:
+    static constexpr uint8_t MAX_FRACTION_DIGITS = 9;
+    // "2024-07-01T12:00:00.123456789+05:45", excluding the terminating null
+    static constexpr size_t RFC3339_MAX_LENGTH = 35;
+    static constexpr size_t DATE_TIME_LENGTH = 19;
+
+    // "00" "01" ... "99"
+    static constexpr char DIGIT_PAIRS[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    static void writePair(char* out, uint8_t value) {
+        out[0] = DIGIT_PAIRS[value * 2];
+        out[1] = DIGIT_PAIRS[value * 2 + 1];
+    }
+
+    // Right-aligned, zero-padded to exactly `digits` characters
+    static void writeDigits(char* out, uint32_t value, uint8_t digits) {
+        while (digits >= 2) {
+            digits -= 2;
+            writePair(out + digits, (uint8_t)(value % 100));
+            value /= 100;
+        }
+        if (digits) {
+            out[0] = (char)('0' + value % 10);
+        }
+    }
+
+    // "YYYY-MM-DD HH:MM:SS" (DATE_TIME_LENGTH characters, no null) of a
+    // civil time whose year is within 0000-9999
+    static void writeDateTime(const NTPCivilTime& civil, char* out);
+
+    // RFC 3339 text of a UTC instant shown at a fixed UTC offset, with
+    // 0-9 fraction digits taken (truncated) from `nanos`; "Z" when the
+    // offset is zero. Returns the length written, excluding the null, or
+    // 0 if the buffer is too small, the local year is outside 0000-9999
+    // or the offset is not representable as +HH:MM.
+    static size_t rfc3339(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                          uint8_t fractionDigits, char* buffer, size_t length);
+
+    // Parse an RFC 3339 / ISO 8601 extended timestamp into UTC seconds and
+    // nanoseconds: "YYYY-MM-DD" optionally followed by 'T' (or 't' or a
+    // space) and "HH:MM[:SS[.fraction]]" with 'Z' or a +HH:MM / +HHMM
+    // offset. A missing offset means UTC; fraction digits past the ninth
+    // are truncated; second 60 is a leap second and lands on the next
+    // minute. The whole text must match. Returns false on malformed input
+    // or an invalid date and leaves the outputs untouched.
+    static bool parseRFC3339(const char* text, size_t length, int64_t& utc, uint32_t& nanos);
+    static bool parseRFC3339(const char* text, int64_t& utc, uint32_t& nanos);
+
+    // Any fixed layout; same return convention as rfc3339()
+    static size_t format(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                         NTPTimeFormat format, char* buffer, size_t length);
+
+    // Finish a layout from its "YYYY-MM-DD HH:MM:SS" text
+    static size_t compose(const char* dateTime, uint32_t nanos, int16_t offsetMinutes,
+                          NTPTimeFormat format, char* buffer, size_t length);
+
+    // Fixed-width strftime() conversions compiled by NTPFixedFormat
+    enum FieldKind : uint8_t {
+        FIELD_LITERAL,      // One character of the pattern, or %%
+        FIELD_YEAR,         // %Y, 4 digits
+        FIELD_YEAR2,        // %y
+        FIELD_MONTH,        // %m
+        FIELD_DAY,          // %d
+        FIELD_HOUR,         // %H
+        FIELD_HOUR12,       // %I
+        FIELD_MINUTE,       // %M
+        FIELD_SECOND,       // %S
+        FIELD_AM_PM,        // %p, "AM"/"PM"
+        FIELD_YEAR_DAY,     // %j, 001-366
+        FIELD_WEEKDAY_NAME, // %a, "Sun"
+        FIELD_MONTH_NAME,   // %b, "Jan"
+        FIELD_OFFSET,       // %z, "+0100"
+        FIELD_INVALID
+    };
+    struct Field {
+        FieldKind kind;
+        char literal;
+    };
+
+    static constexpr FieldKind fieldKind(char conversion) {
+        switch (conversion) {
+            case 'Y': return FIELD_YEAR;
+            case 'y': return FIELD_YEAR2;
+            case 'm': return FIELD_MONTH;
+            case 'd': return FIELD_DAY;
+            case 'H': return FIELD_HOUR;
+            case 'I': return FIELD_HOUR12;
+            case 'M': return FIELD_MINUTE;
+            case 'S': return FIELD_SECOND;
+            case 'p': return FIELD_AM_PM;
+            case 'j': return FIELD_YEAR_DAY;
+            case 'a': return FIELD_WEEKDAY_NAME;
+            case 'b': return FIELD_MONTH_NAME;
+            case 'z': return FIELD_OFFSET;
+            default:  return FIELD_INVALID;
+        }
+    }
+
+    static constexpr uint8_t fieldWidth(FieldKind kind) {
+        switch (kind) {
+            case FIELD_LITERAL:      return 1;
+            case FIELD_YEAR:         return 4;
+            case FIELD_YEAR_DAY:
+            case FIELD_WEEKDAY_NAME:
+            case FIELD_MONTH_NAME:   return 3;
+            case FIELD_OFFSET:       return 5;
+            default:                 return 2;
+        }
+    }
+
+    // Shorthands for other conversions, nullptr if none
+    static constexpr const char* expansion(char conversion) {
+        return conversion == 'F' ? "%Y-%m-%d"
+             : conversion == 'T' ? "%H:%M:%S"
+             : conversion == 'R' ? "%H:%M"
+             : nullptr;
+    }
+
+    // Translate a pattern into fields, or just count them if `out` is
+    // nullptr. False on a conversion outside the fixed-width set.
+    static constexpr bool compile(const char* pattern, Field* out, size_t& count) {
+        for (const char* p = pattern; *p; p++) {
+            if (*p != '%') {
+                emit(out, count, FIELD_LITERAL, *p);
+                continue;
+            }
+            char conversion = *++p;
+            if (conversion == '%') {
+                emit(out, count, FIELD_LITERAL, '%');
+            } else if (const char* shorthand = expansion(conversion)) {
+                if (!compile(shorthand, out, count)) return false;
+            } else if (fieldKind(conversion) != FIELD_INVALID) {
+                emit(out, count, fieldKind(conversion), 0);
+            } else {
+                return false;  // Also a trailing '%'
+            }
+        }
+        return true;
+    }
+
+    template <FieldKind Kind>
+    static void writeField(char* out, const NTPCivilTime& civil, int16_t offsetMinutes, char literal) {
+        if constexpr (Kind == FIELD_LITERAL) {
+            out[0] = literal;
+        } else if constexpr (Kind == FIELD_YEAR) {
+            writePair(out, (uint8_t)(civil.year / 100));
+            writePair(out + 2, (uint8_t)(civil.year % 100));
+        } else if constexpr (Kind == FIELD_YEAR2) {
+            writePair(out, (uint8_t)(civil.year % 100));
+        } else if constexpr (Kind == FIELD_MONTH) {
+            writePair(out, civil.month);
+        } else if constexpr (Kind == FIELD_DAY) {
+            writePair(out, civil.day);
+        } else if constexpr (Kind == FIELD_HOUR) {
+            writePair(out, civil.hour);
+        } else if constexpr (Kind == FIELD_HOUR12) {
+            writePair(out, (uint8_t)(civil.hour % 12 ? civil.hour % 12 : 12));
+        } else if constexpr (Kind == FIELD_MINUTE) {
+            writePair(out, civil.minute);
+        } else if constexpr (Kind == FIELD_SECOND) {
+            writePair(out, civil.second);
+        } else if constexpr (Kind == FIELD_AM_PM) {
+            out[0] = civil.hour < 12 ? 'A' : 'P';
+            out[1] = 'M';
+        } else if constexpr (Kind == FIELD_YEAR_DAY) {
+            writeDigits(out, civil.yearDay + 1u, 3);
+        } else if constexpr (Kind == FIELD_WEEKDAY_NAME) {
+            copyName(out, WEEKDAY_NAMES + civil.weekday * 3);
+        } else if constexpr (Kind == FIELD_MONTH_NAME) {
+            copyName(out, MONTH_NAMES + (civil.month - 1) * 3);
+        } else if constexpr (Kind == FIELD_OFFSET) {
+            uint16_t magnitude = offsetMinutes < 0 ? -offsetMinutes : offsetMinutes;
+            out[0] = offsetMinutes < 0 ? '-' : '+';
+            writePair(out + 1, (uint8_t)(magnitude / 60));
+            writePair(out + 3, (uint8_t)(magnitude % 60));
+        } else {
+            static_assert(Kind == FIELD_LITERAL, "No writer for this field");
+        }
+    }
+
+    static constexpr char WEEKDAY_NAMES[] = "SunMonTueWedThuFriSat";
+    static constexpr char MONTH_NAMES[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+private:
+    static constexpr void emit(Field* out, size_t& count, FieldKind kind, char literal) {
+        if (out != nullptr) {
+            out[count] = Field{kind, literal};
+        }
+        count++;
+    }
+
+    static void copyName(char* out, const char* name) {
+        out[0] = name[0];
+        out[1] = name[1];
+        out[2] = name[2];
+    }
+
+    static size_t composeRFC3339(const char* dateTime, uint32_t nanos, int16_t offsetMinutes,
+                                 uint8_t fractionDigits, char* buffer, size_t length);
+};
+
+/**
+ * Memo of the text of the last formatted second. Calls within the same
+ * second only copy the text and patch the fraction; when the clock moves
+ * forward within the day, the broken-down time is stepped in place and
+ * only the changed digit pairs are rewritten. Not synchronized: give each
+ * task its own memo.
+ */
+class NTPFormatMemo {
+public:
+    NTPFormatMemo() : _local(INT64_MIN), _civil(), _text() {}
+
+    // Same result as NTPFormat::format()
+    size_t format(int64_t utc, uint32_t nanos, int16_t offsetMinutes,
+                  NTPTimeFormat format, char* buffer, size_t length);
+
+private:
+    bool advance(int64_t local);
+
+    int64_t _local;       // Local second of _text, INT64_MIN if empty
+    NTPCivilTime _civil;
+    char _text[NTPFormat::DATE_TIME_LENGTH];
+};
+
+/**
+ * strftime()-style pattern compiled at build time. Every supported
+ * conversion has a fixed width, so the pattern becomes a fixed sequence of
+ * field writers at known positions, and LENGTH is exact:
+ *
+ *   static constexpr char LOG_FORMAT[] = "%Y-%m-%dT%H:%M:%S";
+ *   char text[NTPFixedFormat<LOG_FORMAT>::LENGTH + 1];
+ *   NTPFixedFormat<LOG_FORMAT>::format(utc, offsetMinutes, text);
+ *
+ * C++17 cannot take a string literal as a template argument, so the
+ * pattern is a constexpr array with static storage. Conversions outside
+ * NTPFormat::fieldKind() (plus %F, %T, %R and %%) fail to compile.
+ */
+template <const char* Pattern>
+class NTPFixedFormat {
+    static constexpr size_t countFields() {
+        size_t count = 0;
+        return NTPFormat::compile(Pattern, nullptr, count) ? count : 0;
+    }
+    static constexpr bool valid() {
+        size_t count = 0;
+        return NTPFormat::compile(Pattern, nullptr, count);
+    }
+
+public:
+    static_assert(valid(), "Unsupported conversion in time format (see NTPFormat::fieldKind())");
+
+    static constexpr size_t FIELD_COUNT = countFields();
+    using Fields = std::array<NTPFormat::Field, FIELD_COUNT>;
+
+private:
+    static constexpr Fields compileFields() {
+        Fields fields{};
+        size_t count = 0;
+        NTPFormat::compile(Pattern, fields.data(), count);
+        return fields;
+    }
+
+public:
+    static constexpr Fields FIELDS = compileFields();
+
+    // Offset of a field in the output
+    static constexpr size_t position(size_t field) {
+        size_t offset = 0;
+        for (size_t i = 0; i < field; i++) {
+            offset += NTPFormat::fieldWidth(FIELDS[i].kind);
+        }
+        return offset;
+    }
+    static constexpr size_t LENGTH = position(FIELD_COUNT);  // Excluding the null
+
+    // Text of a broken-down local time; `offsetMinutes` feeds %z. Returns
+    // LENGTH, or 0 if the buffer is too small, the year is outside
+    // 0000-9999 or the offset does not fit +hhmm.
+    static size_t write(const NTPCivilTime& civil, int16_t offsetMinutes, char* buffer, size_t length) {
+        if (buffer == nullptr || length <= LENGTH) return 0;
+        if (civil.year < 0 || civil.year > 9999) return 0;
+        if (offsetMinutes <= -100 * 60 || offsetMinutes >= 100 * 60) return 0;
+        writeFields(civil, offsetMinutes, buffer, std::make_index_sequence<FIELD_COUNT>());
+        buffer[LENGTH] = '\0';
+        return LENGTH;
+    }
+
+    static size_t format(int64_t utc, int16_t offsetMinutes, char* buffer, size_t length) {
+        return write(NTPCalendar::fromEpoch(utc + offsetMinutes * 60L), offsetMinutes, buffer, length);
+    }
+    template <size_t N>
+    static size_t format(int64_t utc, int16_t offsetMinutes, char (&buffer)[N]) {
+        static_assert(N > LENGTH, "Buffer too small for this time format");
+        return format(utc, offsetMinutes, buffer, N);
+    }
+
+private:
+    template <size_t... I>
+    static void writeFields(const NTPCivilTime& civil, int16_t offsetMinutes, char* out,
+                            std::index_sequence<I...>) {
+        (NTPFormat::writeField<FIELDS[I].kind>(out + position(I), civil, offsetMinutes, FIELDS[I].literal), ...);
+    }
+};
+
+#endif // NTP_FORMAT_H
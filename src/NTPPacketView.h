@@ -0,0 +1,81 @@
+#ifndef NTP_PACKET_VIEW_H
+#define NTP_PACKET_VIEW_H
+
+#include <stdint.h>
+
+/**
+ * Wire layout of an NTPv4 packet (RFC 5905 figure 8) and a read-only view
+ * that decodes fields straight from the receive buffer. Every field is
+ * big-endian on the wire; accessors take the byte offset as a template
+ * argument, so decoding compiles to a few loads and shifts with no copy
+ * into a struct and no byte-swapping pass.
+ */
+class NTPPacketView {
+public:
+    static constexpr uint8_t SIZE = 48;
+
+    // Byte offsets of the fields
+    static constexpr uint8_t LI_VN_MODE = 0;
+    static constexpr uint8_t STRATUM = 1;
+    static constexpr uint8_t POLL = 2;
+    static constexpr uint8_t PRECISION = 3;
+    static constexpr uint8_t ROOT_DELAY = 4;
+    static constexpr uint8_t ROOT_DISPERSION = 8;
+    static constexpr uint8_t REFERENCE_ID = 12;
+    static constexpr uint8_t REFERENCE_TIMESTAMP = 16;
+    static constexpr uint8_t ORIGIN_TIMESTAMP = 24;
+    static constexpr uint8_t RECEIVE_TIMESTAMP = 32;
+    static constexpr uint8_t TRANSMIT_TIMESTAMP = 40;
+
+    explicit constexpr NTPPacketView(const uint8_t* data) : _data(data) {}
+
+    constexpr uint8_t leap() const { return _data[LI_VN_MODE] >> 6; }
+    constexpr uint8_t version() const { return (_data[LI_VN_MODE] >> 3) & 0x07; }
+    constexpr uint8_t mode() const { return _data[LI_VN_MODE] & 0x07; }
+    constexpr uint8_t stratum() const { return _data[STRATUM]; }
+    constexpr uint32_t referenceId() const { return word<REFERENCE_ID>(); }
+    constexpr uint32_t referenceSeconds() const { return word<REFERENCE_TIMESTAMP>(); }
+    constexpr uint32_t referenceFraction() const { return word<REFERENCE_TIMESTAMP + 4>(); }
+    constexpr uint32_t originSeconds() const { return word<ORIGIN_TIMESTAMP>(); }
+    constexpr uint32_t originFraction() const { return word<ORIGIN_TIMESTAMP + 4>(); }
+    constexpr uint32_t receiveSeconds() const { return word<RECEIVE_TIMESTAMP>(); }
+    constexpr uint32_t receiveFraction() const { return word<RECEIVE_TIMESTAMP + 4>(); }
+    constexpr uint32_t transmitSeconds() const { return word<TRANSMIT_TIMESTAMP>(); }
+    constexpr uint32_t transmitFraction() const { return word<TRANSMIT_TIMESTAMP + 4>(); }
+
+    // Big-endian 32-bit field at a fixed offset
+    template <uint8_t Offset>
+    constexpr uint32_t word() const {
+        static_assert(Offset + 4 <= SIZE, "Field lies outside the NTP packet");
+        return ((uint32_t)_data[Offset] << 24) | ((uint32_t)_data[Offset + 1] << 16) |
+               ((uint32_t)_data[Offset + 2] << 8) | (uint32_t)_data[Offset + 3];
+    }
+
+    // Store a big-endian 32-bit field at a fixed offset of a packet buffer
+    template <uint8_t Offset>
+    static void putWord(uint8_t* data, uint32_t value) {
+        static_assert(Offset + 4 <= SIZE, "Field lies outside the NTP packet");
+        data[Offset] = (uint8_t)(value >> 24);
+        data[Offset + 1] = (uint8_t)(value >> 16);
+        data[Offset + 2] = (uint8_t)(value >> 8);
+        data[Offset + 3] = (uint8_t)value;
+    }
+
+private:
+    const uint8_t* _data;
+};
+
+/**
+ * Client request, fixed at compile time: LI = 0, VN = 4, mode 3 (client)
+ * and all other fields zero. Only the transmit timestamp is filled in,
+ * right before the packet leaves.
+ */
+struct NTPRequestTemplate {
+    uint8_t bytes[NTPPacketView::SIZE];
+
+    constexpr NTPRequestTemplate() : bytes() {
+        bytes[NTPPacketView::LI_VN_MODE] = (0 << 6) | (4 << 3) | 3;
+    }
+};
+
+#endif // NTP_PACKET_VIEW_H
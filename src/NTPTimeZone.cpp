@@ -0,0 +1,323 @@
+#include "NTPTimeZone.h"
+#include <ctype.h>
+#include <string.h>
+
+NTPTimeZone::NTPTimeZone() : _config(), _id(NTP_ZONE_NONE), _cache() {
+    strncpy(_config.name, "UTC", sizeof(_config.name));
+    _cache.from = INT64_MIN;
+    _cache.until = INT64_MAX;
+    _cache.zone = NTP_ZONE_NONE;
+}
+
+NTPTimeZone::NTPTimeZone(const Config& config) : _config(config), _id(NTP_ZONE_NONE), _cache() {
+    _cache.from = _cache.until = 0;  // Empty: first lookup fills it
+    _cache.zone = NTP_ZONE_NONE;
+}
+
+NTPTimeZone::NTPTimeZone(NTPZoneId zone) : NTPTimeZone() {
+    if (zone < NTP_ZONE_COUNT && parse(NTP_ZONES[zone].posixTZ, _config)) {
+        _id = zone;
+        _cache.from = _cache.until = 0;
+        _cache.zone = zone;
+    }
+}
+
+bool NTPTimeZone::fromPosix(const char* posixTZ, NTPTimeZone& out) {
+    Config config;
+    if (!parse(posixTZ, config)) return false;
+    out = NTPTimeZone(config);
+    return true;
+}
+
+NTPZoneId NTPTimeZone::find(const char* ianaName) {
+    if (ianaName == nullptr) return NTP_ZONE_NONE;
+    for (uint8_t i = 0; i < NTP_ZONE_COUNT; i++) {
+        if (strcmp(NTP_ZONES[i].name, ianaName) == 0) {
+            return (NTPZoneId)i;
+        }
+    }
+    return NTP_ZONE_NONE;
+}
+
+const char* NTPTimeZone::zoneName(NTPZoneId zone) {
+    return zone < NTP_ZONE_COUNT ? NTP_ZONES[zone].name : "?";
+}
+
+// POSIX TZ parsing helpers. Each advances the cursor past what it accepted
+// and returns false on malformed input.
+
+static bool parseTZNumber(const char*& p, int maxValue, int& out) {
+    if (*p < '0' || *p > '9') return false;
+    int value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > maxValue) return false;
+    }
+    out = value;
+    return true;
+}
+
+// Alphabetic name of at least three characters, or <...> with digits and signs
+static bool parseTZName(const char*& p, char* out, uint8_t maxLength) {
+    uint8_t length = 0;
+    bool quoted = (*p == '<');
+    if (quoted) p++;
+    while (isalpha((unsigned char)*p) ||
+           (quoted && (isdigit((unsigned char)*p) || *p == '+' || *p == '-'))) {
+        if (length >= maxLength) return false;
+        out[length++] = *p++;
+    }
+    if (quoted && *p++ != '>') return false;
+    out[length] = '\0';
+    return length >= 3;
+}
+
+// [+|-]hh[:mm[:ss]] in seconds
+static bool parseTZTime(const char*& p, int maxHours, int32_t& seconds) {
+    int32_t sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = (*p++ == '-') ? -1 : 1;
+    }
+    int hours = 0, minutes = 0, secs = 0;
+    if (!parseTZNumber(p, maxHours, hours)) return false;
+    if (*p == ':') {
+        p++;
+        if (!parseTZNumber(p, 59, minutes)) return false;
+        if (*p == ':') {
+            p++;
+            if (!parseTZNumber(p, 59, secs)) return false;
+        }
+    }
+    seconds = sign * (hours * 3600L + minutes * 60L + secs);
+    return true;
+}
+
+// Mm.w.d, Jn or n, followed by an optional /time (default 02:00)
+static bool parseTZTransition(const char*& p, NTPTimeZone::DSTRule& rule, uint8_t& month,
+                              uint8_t& week, uint8_t& dayOfWeek, uint16_t& day,
+                              int16_t& hour, int8_t& minute) {
+    int value = 0;
+    if (*p == 'M') {
+        p++;
+        rule = NTPTimeZone::DST_RULE_MONTH_WEEK_DAY;
+        if (!parseTZNumber(p, 12, value) || value < 1 || *p++ != '.') return false;
+        month = value;
+        if (!parseTZNumber(p, 5, value) || value < 1 || *p++ != '.') return false;
+        week = value;
+        if (!parseTZNumber(p, 6, value)) return false;
+        dayOfWeek = value;
+    } else if (*p == 'J') {
+        p++;
+        rule = NTPTimeZone::DST_RULE_JULIAN_DAY;
+        if (!parseTZNumber(p, 365, value) || value < 1) return false;
+        day = value;
+    } else {
+        rule = NTPTimeZone::DST_RULE_DAY_OF_YEAR;
+        if (!parseTZNumber(p, 365, value)) return false;
+        day = value;
+    }
+    
+    int32_t seconds = 2 * 3600L;
+    if (*p == '/' && !parseTZTime(++p, 167, seconds)) return false;
+    hour = seconds / 3600;
+    minute = (seconds / 60) % 60;  // Seconds are dropped; rules use whole minutes
+    return true;
+}
+
+bool NTPTimeZone::parse(const char* posixTZ, Config& out) {
+    if (posixTZ == nullptr) return false;
+    
+    const char* p = posixTZ;
+    if (*p == ':') return false;  // Implementation-defined form (zone file name)
+    
+    Config config = {};
+    int32_t stdSeconds = 0;
+    if (!parseTZName(p, config.name, MAX_NAME_LENGTH) || !parseTZTime(p, 24, stdSeconds)) {
+        return false;
+    }
+    // POSIX offsets are west-positive, ours east-positive
+    config.offsetMinutes = -stdSeconds / 60;
+    
+    if (*p != '\0') {
+        char dstName[MAX_NAME_LENGTH + 1];
+        if (!parseTZName(p, dstName, MAX_NAME_LENGTH)) return false;
+        config.useDST = true;
+        config.dstOffsetMinutes = 60;  // Default: one hour ahead of standard time
+        
+        if (*p != ',' && *p != '\0') {
+            int32_t dstSeconds = 0;
+            if (!parseTZTime(p, 24, dstSeconds)) return false;
+            config.dstOffsetMinutes = -dstSeconds / 60 - config.offsetMinutes;
+        }
+        
+        if (*p == ',') {
+            p++;
+            if (!parseTZTransition(p, config.dstStartRule, config.dstStartMonth,
+                                   config.dstStartWeek, config.dstStartDayOfWeek,
+                                   config.dstStartDay, config.dstStartHour,
+                                   config.dstStartMinute) ||
+                *p++ != ',' ||
+                !parseTZTransition(p, config.dstEndRule, config.dstEndMonth,
+                                   config.dstEndWeek, config.dstEndDayOfWeek,
+                                   config.dstEndDay, config.dstEndHour,
+                                   config.dstEndMinute)) {
+                return false;
+            }
+        } else {
+            // No rule given: US rules, as most C libraries assume
+            config.dstStartMonth = 3;
+            config.dstStartWeek = 2;
+            config.dstStartHour = 2;
+            config.dstEndMonth = 11;
+            config.dstEndWeek = 1;
+            config.dstEndHour = 2;
+        }
+    }
+    
+    if (*p != '\0') return false;  // Trailing garbage
+    
+    out = config;
+    return true;
+}
+
+int64_t NTPTimeZone::transition(const Config& tz, int32_t year, bool start) {
+    DSTRule rule = start ? tz.dstStartRule : tz.dstEndRule;
+    int64_t days = NTPCalendar::daysFromCivil(year, 1, 1);
+    
+    if (rule == DST_RULE_JULIAN_DAY) {
+        uint16_t day = start ? tz.dstStartDay : tz.dstEndDay;
+        days += day - 1 + (day >= 60 && NTPCalendar::isLeapYear(year) ? 1 : 0);
+    } else if (rule == DST_RULE_DAY_OF_YEAR) {
+        days += start ? tz.dstStartDay : tz.dstEndDay;
+    } else {
+        uint8_t month = start ? tz.dstStartMonth : tz.dstEndMonth;
+        uint8_t week = start ? tz.dstStartWeek : tz.dstEndWeek;
+        uint8_t dayOfWeek = start ? tz.dstStartDayOfWeek : tz.dstEndDayOfWeek;
+        
+        days = NTPCalendar::daysFromCivil(year, month, 1);
+        int firstDayOfWeek = NTPCalendar::weekdayFromDays(days);
+        int daysUntilTarget = (dayOfWeek - firstDayOfWeek + 7) % 7;
+        int targetDay = 1 + daysUntilTarget + (week - 1) * 7;
+        
+        // Handle "last" week of month
+        if (week == 5) {
+            int daysInMon = NTPCalendar::daysInMonth(year, month);
+            while (targetDay > daysInMon) {
+                targetDay -= 7;
+            }
+        }
+        days += targetDay - 1;
+    }
+    
+    int32_t localSeconds = start ? tz.dstStartHour * 3600L + tz.dstStartMinute * 60L
+                                 : tz.dstEndHour * 3600L + tz.dstEndMinute * 60L;
+    // DST starts on standard time and ends on daylight time
+    int32_t offsetMinutes = tz.offsetMinutes + (start ? 0 : tz.dstOffsetMinutes);
+    return days * NTPCalendar::SECONDS_PER_DAY + localSeconds - offsetMinutes * 60L;
+}
+
+void NTPTimeZone::lookup(time_t utc, Interval& out) const {
+    out.zone = _id;
+    if (_id != NTP_ZONE_NONE && (int64_t)utc < (int64_t)NTP_ZONES[_id].footerFrom) {
+        tableInterval(utc, out);
+    } else {
+        ruleInterval(_config, utc, _id != NTP_ZONE_NONE ? NTP_ZONES[_id].footerFrom : INT64_MIN, out);
+    }
+}
+
+void NTPTimeZone::tableInterval(int64_t utc, Interval& out) const {
+    const NTPZoneEntry& entry = NTP_ZONES[_id];
+    uint8_t type = entry.initialType;
+    
+    // Binary search for the last block starting at or before utc
+    const NTPZoneBlock* blocks = NTP_ZONE_BLOCKS + entry.firstBlock;
+    uint8_t lo = 0;
+    uint8_t hi = entry.blockCount;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if ((int64_t)blocks[mid].start <= utc) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    int64_t nextBlock = lo < entry.blockCount ? (int64_t)blocks[lo].start : (int64_t)entry.footerFrom;
+    if (lo == 0) {
+        out.from = INT64_MIN;  // Before the first transition
+        out.until = nextBlock;
+    } else {
+        // Walk the deltas inside the block
+        const NTPZoneBlock& block = blocks[lo - 1];
+        uint16_t end = lo < entry.blockCount ? blocks[lo].first
+                                             : entry.firstTransition + entry.transitionCount;
+        uint16_t i = block.first;
+        int64_t when = block.start;
+        out.until = nextBlock;
+        while (i + 1 < end) {
+            int64_t next = when + (int64_t)NTP_ZONE_DELTAS[i + 1] * NTP_ZONE_DELTA_UNIT;
+            if (next > utc) {
+                out.until = next;
+                break;
+            }
+            when = next;
+            i++;
+        }
+        out.from = when;
+        type = NTP_ZONE_TYPES[i];
+    }
+    out.offsetMinutes = NTP_ZONE_OFFSETS[type & ~NTP_ZONE_DST_FLAG];
+    out.dst = (type & NTP_ZONE_DST_FLAG) != 0;
+}
+
+void NTPTimeZone::ruleInterval(const Config& config, int64_t utc, int64_t notBefore, Interval& out) {
+    out.from = notBefore;
+    out.until = INT64_MAX;
+    out.offsetMinutes = config.offsetMinutes;
+    out.dst = false;
+    if (!config.useDST) return;
+    
+    // Transitions of the previous, current and next year in time order
+    int32_t year = NTPCalendar::yearOf(utc);
+    int64_t when[6];
+    bool toDst[6];
+    for (uint8_t i = 0; i < 6; i++) {
+        toDst[i] = (i % 2 == 0);
+        when[i] = transition(config, year - 1 + i / 2, toDst[i]);
+        for (uint8_t j = i; j > 0 && when[j] < when[j - 1]; j--) {
+            int64_t w = when[j]; when[j] = when[j - 1]; when[j - 1] = w;
+            bool d = toDst[j]; toDst[j] = toDst[j - 1]; toDst[j - 1] = d;
+        }
+    }
+    for (uint8_t i = 0; i < 6; i++) {
+        if (when[i] > utc) {
+            out.until = when[i];
+            break;
+        }
+        out.dst = toDst[i];
+        if (when[i] > out.from) out.from = when[i];
+    }
+    if (out.dst) out.offsetMinutes += config.dstOffsetMinutes;
+}
+
+void NTPTimeZone::toCivil(const time_t* utc, size_t count, NTPCivilTime* out) const {
+    int64_t cachedDays = INT64_MIN;
+    NTPCivilTime date{};
+    for (size_t i = 0; i < count; i++) {
+        int64_t local = (int64_t)utc[i] + at(utc[i]).offsetMinutes * 60L;
+        int64_t days = local / NTPCalendar::SECONDS_PER_DAY;
+        int64_t secs = local % NTPCalendar::SECONDS_PER_DAY;
+        if (secs < 0) {
+            secs += NTPCalendar::SECONDS_PER_DAY;
+            days--;
+        }
+        if (days != cachedDays) {
+            date = NTPCalendar::civilFromDays(days);
+            cachedDays = days;
+        }
+        out[i] = date;
+        out[i].hour = (uint8_t)(secs / 3600);
+        out[i].minute = (uint8_t)(secs / 60 % 60);
+        out[i].second = (uint8_t)(secs % 60);
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef NTP_TIME_ZONE_H
+#define NTP_TIME_ZONE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "NTPCalendar.h"
+#include "NTPZoneData.h"
+
+/**
+ * Time zone handle: either a rule (TimeZoneConfig, e.g. parsed from a POSIX
+ * TZ string) or a compiled IANA zone from NTPZoneData.h. A handle is a
+ * plain value, independent of any client, and remembers the interval of
+ * its last lookup, so converting timestamps near each other costs two
+ * compares. The cache is not synchronized; give each task its own handle.
+ */
+class NTPTimeZone {
+public:
+    // How a DST transition date is given (POSIX TZ Mm.w.d, Jn and n forms)
+    enum DSTRule : uint8_t {
+        DST_RULE_MONTH_WEEK_DAY,  // dstXxxWeek/Month/DayOfWeek
+        DST_RULE_JULIAN_DAY,      // dstXxxDay 1-365, February 29 never counted
+        DST_RULE_DAY_OF_YEAR      // dstXxxDay 0-365, February 29 counted
+    };
+    static constexpr uint8_t MAX_NAME_LENGTH = 7;  // Excluding the terminating null
+
+    // Time zone rule. Transition times are local wall-clock time:
+    // standard time for the start of DST, daylight time for its end.
+    struct Config {
+        int16_t offsetMinutes;    // UTC offset in minutes
+        char name[MAX_NAME_LENGTH + 1];  // e.g., "EST", "PST"
+        bool useDST;              // Use daylight saving time
+        uint8_t dstStartWeek;     // Week of month (1-5, 5=last)
+        uint8_t dstStartMonth;    // Month (1-12)
+        uint8_t dstStartDayOfWeek;// Day of week (0=Sunday)
+        int16_t dstStartHour;     // Hour to start DST (POSIX allows -167..167)
+        uint8_t dstEndWeek;       // Week of month (1-5, 5=last)
+        uint8_t dstEndMonth;      // Month (1-12)
+        uint8_t dstEndDayOfWeek;  // Day of week (0=Sunday)
+        int16_t dstEndHour;       // Hour to end DST
+        int16_t dstOffsetMinutes; // Additional offset during DST
+
+        // Set by parse(); the defaults keep the fields above in effect
+        DSTRule dstStartRule = DST_RULE_MONTH_WEEK_DAY;
+        DSTRule dstEndRule = DST_RULE_MONTH_WEEK_DAY;
+        uint16_t dstStartDay = 0; // Day for the Jn/n rules
+        uint16_t dstEndDay = 0;
+        int8_t dstStartMinute = 0;// Added to the hour, with the same sign
+        int8_t dstEndMinute = 0;
+    };
+
+    // Result of a lookup and the range of instants it holds for
+    struct Interval {
+        int64_t from;             // UTC seconds, inclusive
+        int64_t until;            // UTC seconds, exclusive
+        int16_t offsetMinutes;    // Total UTC offset, DST included
+        bool dst;
+        NTPZoneId zone;
+    };
+
+    NTPTimeZone();                              // UTC
+    explicit NTPTimeZone(const Config& config);
+    explicit NTPTimeZone(NTPZoneId zone);       // UTC if the id is not compiled in
+
+    // POSIX TZ string, e.g. "CET-1CEST,M3.5.0,M10.5.0/3". Return false on
+    // malformed input and leave the output untouched.
+    static bool parse(const char* posixTZ, Config& out);
+    static bool fromPosix(const char* posixTZ, NTPTimeZone& out);
+
+    static NTPZoneId find(const char* ianaName);  // NTP_ZONE_NONE if not compiled in
+    static const char* zoneName(NTPZoneId zone);
+
+    // Offset and DST state at a UTC instant, from the cache when possible
+    [[nodiscard]] int16_t offsetMinutes(time_t utc) const { return at(utc).offsetMinutes; }
+    [[nodiscard]] bool isDST(time_t utc) const { return at(utc).dst; }
+    [[nodiscard]] time_t toLocal(time_t utc) const { return utc + at(utc).offsetMinutes * 60L; }
+    const Interval& at(time_t utc) const {
+        if (utc < _cache.from || utc >= _cache.until) {
+            lookup(utc, _cache);
+        }
+        return _cache;
+    }
+
+    // Local civil time of `count` UTC instants. Sorted input is cheapest:
+    // the offset is looked up once per interval between transitions and
+    // the date once per local day.
+    void toCivil(const time_t* utc, size_t count, NTPCivilTime* out) const;
+
+    // Uncached lookup
+    void lookup(time_t utc, Interval& out) const;
+
+    [[nodiscard]] const Config& config() const noexcept { return _config; }
+    [[nodiscard]] NTPZoneId id() const noexcept { return _id; }  // NTP_ZONE_NONE if rule-based
+    [[nodiscard]] const char* name() const { return _id != NTP_ZONE_NONE ? NTP_ZONES[_id].name : _config.name; }
+
+    // UTC instant at which DST starts (or ends) in a year under a rule
+    static int64_t transition(const Config& config, int32_t year, bool start);
+
+private:
+    static void ruleInterval(const Config& config, int64_t utc, int64_t notBefore, Interval& out);
+    void tableInterval(int64_t utc, Interval& out) const;
+
+    Config _config;       // Rule; for compiled zones the rule after the table
+    NTPZoneId _id;
+    mutable Interval _cache;
+};
+
+#endif // NTP_TIME_ZONE_H
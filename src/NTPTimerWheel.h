@@ -0,0 +1,185 @@
+#ifndef NTP_TIMER_WHEEL_H
+#define NTP_TIMER_WHEEL_H
+
+#include <stdint.h>
+
+/**
+ * Small hierarchical timer wheel used to schedule per-server polls.
+ *
+ * Three levels of 64 slots cover 64^3 ticks (~3 days at one tick per
+ * second). Entries further out are parked in the outermost level and
+ * re-cascaded until they are due. Entries are identified by a small id
+ * (the server index) and linked intrusively, so the wheel never allocates
+ * and advancing by one tick is O(1) regardless of the number of entries.
+ */
+template <uint8_t MaxEntries>
+class NTPTimerWheel {
+public:
+    static constexpr uint8_t NONE = 0xFF;
+    static constexpr uint8_t LEVELS = 3;
+    static constexpr uint8_t SLOT_BITS = 6;
+    static constexpr uint8_t SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+    static constexpr uint32_t RANGE = 1UL << (SLOT_BITS * LEVELS);  // Ticks covered
+
+    static_assert(MaxEntries < NONE, "Timer wheel ids must fit below NONE");
+
+    NTPTimerWheel() { reset(0); }
+
+    // Drop all entries and restart the wheel at the given tick
+    void reset(uint32_t now) {
+        _now = now;
+        _armedCount = 0;
+        for (uint8_t l = 0; l < LEVELS; l++) {
+            for (uint8_t s = 0; s < SLOTS; s++) {
+                _heads[l][s] = NONE;
+            }
+        }
+        for (uint8_t i = 0; i < MaxEntries; i++) {
+            _nodes[i].armed = false;
+        }
+    }
+
+    // Arm (or re-arm) an entry. Deadlines at or before now fire on the next tick.
+    void schedule(uint8_t id, uint32_t due) {
+        if (id >= MaxEntries) return;
+        cancel(id);
+        if ((int32_t)(due - _now) <= 0) {
+            due = _now + 1;
+        }
+        _nodes[id].due = due;
+        _nodes[id].armed = true;
+        _armedCount++;
+        link(id);
+    }
+
+    void cancel(uint8_t id) {
+        if (id >= MaxEntries || !_nodes[id].armed) return;
+        unlink(id);
+        _nodes[id].armed = false;
+        _armedCount--;
+    }
+
+    [[nodiscard]] bool isArmed(uint8_t id) const { return id < MaxEntries && _nodes[id].armed; }
+    [[nodiscard]] uint32_t dueTick(uint8_t id) const { return _nodes[id].due; }
+    [[nodiscard]] uint32_t now() const { return _now; }
+    [[nodiscard]] uint8_t armedCount() const { return _armedCount; }
+
+    // Earliest armed deadline, in ticks from now. Returns false when idle.
+    [[nodiscard]] bool ticksUntilNext(uint32_t& ticks) const {
+        if (_armedCount == 0) return false;
+        ticks = UINT32_MAX;
+        for (uint8_t i = 0; i < MaxEntries; i++) {
+            if (_nodes[i].armed && _nodes[i].due - _now < ticks) {
+                ticks = _nodes[i].due - _now;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Advance the wheel to tick `to`, calling fire(id) for every entry that
+     * becomes due. Entries are disarmed before fire() runs, so the callback
+     * may re-schedule them. If it resets the wheel at or past `to`, the
+     * advance stops there instead of wrapping around.
+     */
+    template <typename Fire>
+    void advance(uint32_t to, Fire&& fire) {
+        while ((int32_t)(to - _now) > 0) {
+            if (_armedCount == 0) {
+                _now = to;  // Nothing to cascade or fire
+                break;
+            }
+            _now++;
+
+            // Cascade outer levels into inner ones when an inner level wraps
+            if ((_now & SLOT_MASK) == 0) {
+                if (((_now >> SLOT_BITS) & SLOT_MASK) == 0) {
+                    cascade(2, (_now >> (2 * SLOT_BITS)) & SLOT_MASK);
+                }
+                cascade(1, (_now >> SLOT_BITS) & SLOT_MASK);
+            }
+
+            // Pop entries one at a time so fire() may re-schedule or reset;
+            // schedule() never targets the slot being drained
+            uint8_t id;
+            while ((id = _heads[0][_now & SLOT_MASK]) != NONE) {
+                unlink(id);
+                if ((int32_t)(_nodes[id].due - _now) > 0) {
+                    link(id);  // Parked beyond the wheel range, not yet due
+                } else {
+                    _nodes[id].armed = false;
+                    _armedCount--;
+                    fire(id);
+                }
+            }
+        }
+    }
+
+private:
+    struct Node {
+        uint32_t due;
+        uint8_t next;
+        uint8_t prev;
+        uint8_t level;
+        uint8_t slot;
+        bool armed;
+    };
+
+    uint32_t _now;
+    uint8_t _armedCount;
+    uint8_t _heads[LEVELS][SLOTS];
+    Node _nodes[MaxEntries];
+
+    void link(uint8_t id) {
+        Node& n = _nodes[id];
+        uint32_t delta = n.due - _now;
+        uint32_t expires = n.due;
+        if (delta >= RANGE) {
+            expires = _now + RANGE - 1;  // Park in the outermost level
+            delta = RANGE - 1;
+        }
+
+        if (delta < (1UL << SLOT_BITS)) {
+            n.level = 0;
+            n.slot = expires & SLOT_MASK;
+        } else if (delta < (1UL << (2 * SLOT_BITS))) {
+            n.level = 1;
+            n.slot = (expires >> SLOT_BITS) & SLOT_MASK;
+        } else {
+            n.level = 2;
+            n.slot = (expires >> (2 * SLOT_BITS)) & SLOT_MASK;
+        }
+
+        n.prev = NONE;
+        n.next = _heads[n.level][n.slot];
+        if (n.next != NONE) {
+            _nodes[n.next].prev = id;
+        }
+        _heads[n.level][n.slot] = id;
+    }
+
+    void unlink(uint8_t id) {
+        Node& n = _nodes[id];
+        if (n.prev != NONE) {
+            _nodes[n.prev].next = n.next;
+        } else {
+            _heads[n.level][n.slot] = n.next;
+        }
+        if (n.next != NONE) {
+            _nodes[n.next].prev = n.prev;
+        }
+    }
+
+    void cascade(uint8_t level, uint8_t slot) {
+        uint8_t id = _heads[level][slot];
+        _heads[level][slot] = NONE;
+        while (id != NONE) {
+            uint8_t next = _nodes[id].next;
+            link(id);
+            id = next;
+        }
+    }
+};
+
+#endif // NTP_TIMER_WHEEL_H
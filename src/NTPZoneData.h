@@ -0,0 +1,226 @@
+// Generated by tools/gen_zone_data.py - do not edit.
+// gen_zone_data.py
+
+#ifndef NTP_ZONE_DATA_H
+#define NTP_ZONE_DATA_H
+
+#include <stdint.h>
+
+// Compiled IANA zones
+enum NTPZoneId : uint8_t {
+    NTP_ZONE_UTC,
+    NTP_ZONE_EUROPE_LONDON,
+    NTP_ZONE_EUROPE_BERLIN,
+    NTP_ZONE_EUROPE_PARIS,
+    NTP_ZONE_EUROPE_MADRID,
+    NTP_ZONE_EUROPE_MOSCOW,
+    NTP_ZONE_AMERICA_NEW_YORK,
+    NTP_ZONE_AMERICA_CHICAGO,
+    NTP_ZONE_AMERICA_DENVER,
+    NTP_ZONE_AMERICA_PHOENIX,
+    NTP_ZONE_AMERICA_LOS_ANGELES,
+    NTP_ZONE_AMERICA_SAO_PAULO,
+    NTP_ZONE_ASIA_KOLKATA,
+    NTP_ZONE_ASIA_KATHMANDU,
+    NTP_ZONE_ASIA_SHANGHAI,
+    NTP_ZONE_ASIA_TOKYO,
+    NTP_ZONE_AUSTRALIA_SYDNEY,
+    NTP_ZONE_PACIFIC_AUCKLAND,
+    NTP_ZONE_COUNT,
+    NTP_ZONE_NONE = 0xFF
+};
+
+struct NTPZoneBlock {
+    uint32_t start;       // UTC seconds of the block's first transition
+    uint16_t first;       // Index of that transition in NTP_ZONE_DELTAS/TYPES
+};
+
+struct NTPZoneEntry {
+    const char* name;     // IANA id
+    const char* posixTZ;  // Rule in effect from footerFrom on
+    uint32_t footerFrom;  // UTC seconds; explicit transitions end here
+    uint16_t firstBlock;
+    uint16_t firstTransition;
+    uint8_t blockCount;
+    uint8_t transitionCount;
+    uint8_t initialType;  // Offset index before the first transition (bit 7: DST)
+};
+
+static constexpr uint8_t NTP_ZONE_DST_FLAG = 0x80;
+static constexpr uint16_t NTP_ZONE_DELTA_UNIT = 900;  // Seconds per delta step
+
+// 2704 bytes of transition data for 18 zones
+inline constexpr int16_t NTP_ZONE_OFFSETS[] = {
+    0, 60, 120, 240, 180, -240, -300, -360, -420, -480, -120, -180,
+    330, 345, 540, 480, 660, 600, 780, 720,
+};
+
+inline constexpr NTPZoneBlock NTP_ZONE_BLOCKS[] = {
+    {57722400, 0}, {309924000, 16}, {562122000, 32}, {814323600, 48},
+    {323830800, 49}, {575427600, 65}, {196819200, 81}, {449024400, 97},
+    {701830800, 113}, {135122400, 121}, {386125200, 137}, {638326800, 153},
+    {354920400, 165}, {606870000, 181}, {846370800, 197}, {1099177200, 213},
+    {1414274400, 227}, {9961200, 228}, {262767600, 244}, {514969200, 260},
+    {765356400, 276}, {1018162800, 292}, {9964800, 302}, {262771200, 318},
+    {514972800, 334}, {765360000, 350}, {1018166400, 366}, {9968400, 376},
+    {262774800, 392}, {514976400, 408}, {765363600, 424}, {1018170000, 440},
+    {9972000, 450}, {262778400, 466}, {514980000, 482}, {765367200, 498},
+    {1018173600, 514}, {499748400, 524}, {750826800, 540}, {1003028400, 556},
+    {1255834800, 572}, {1508036400, 588}, {504901800, 592}, {515527200, 593},
+    {57686400, 605}, {309888000, 621}, {562089600, 637}, {814896000, 653},
+    {1067097600, 669}, {152632800, 678}, {404834400, 694}, {655221600, 710},
+    {907423200, 726}, {1159624800, 742},
+};
+
+inline constexpr uint16_t NTP_ZONE_DELTAS[] = {
+    0, 13440, 21504, 13440, 21504, 13440, 21504, 13440, 21504, 14112, 20832, 14112,
+    20832, 14112, 21504, 13440, 0, 13440, 21504, 14780, 20160, 14784, 20160, 14784,
+    20160, 14784, 20832, 14784, 20160, 14784, 20160, 14784, 0, 14784, 20160, 14784,
+    20832, 14112, 20832, 14784, 20160, 14784, 20160, 14784, 20160, 14784, 20160, 14784,
+    0, 0, 16800, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 18144, 17472,
+    17472, 17472, 17472, 17472, 17472, 0, 17472, 17472, 17472, 17472, 18144, 17472,
+    17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 0, 17468, 18152,
+    16800, 18144, 17472, 17472, 17472, 18144, 16800, 17472, 17472, 17472, 17472, 17472,
+    17472, 0, 18144, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472,
+    17472, 17472, 18144, 17472, 17472, 0, 17472, 17472, 17472, 17472, 17472, 17472,
+    17472, 0, 16804, 18140, 16804, 16796, 17476, 18140, 16804, 18152, 17472, 17472,
+    17472, 18144, 16800, 17472, 17472, 0, 17472, 17472, 17472, 17472, 18144, 17472,
+    17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 0, 18144, 17472,
+    17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 17472, 0, 17564, 17476,
+    17564, 17476, 17564, 17572, 17480, 17472, 17472, 17472, 17472, 17472, 17472, 17472,
+    17472, 0, 17472, 17472, 18144, 17472, 17476, 10752, 6716, 17472, 17472, 17472,
+    17472, 17472, 17472, 17472, 18144, 0, 14784, 20160, 14784, 20160, 14784, 20832,
+    14112, 20832, 14112, 20832, 14784, 20160, 14784, 20160, 14784, 0, 14112, 20832,
+    14112, 20832, 14112, 20832, 14784, 20160, 14784, 20160, 14784, 20832, 14112, 0,
+    0, 17468, 17476, 18140, 17476, 17468, 17476, 17468, 6724, 28220, 11428, 23516,
+    17476, 18140, 16804, 18140, 0, 17468, 17476, 17468, 17476, 17468, 17476, 17468,
+    17476, 18140, 16804, 18140, 17476, 17468, 17476, 17468, 0, 17468, 15460, 19484,
+    15460, 20156, 14788, 20156, 14788, 20156, 15460, 19484, 15460, 19484, 15460, 20156,
+    0, 20156, 14788, 20156, 15460, 19484, 15460, 19484, 15460, 19484, 15460, 20156,
+    14788, 20156, 14788, 20156, 0, 19484, 15460, 19484, 15460, 20156, 14788, 20156,
+    14788, 20156, 0, 17468, 17476, 18140, 17476, 17468, 17476, 17468, 6724, 28220,
+    11428, 23516, 17476, 18140, 16804, 18140, 0, 17468, 17476, 17468, 17476, 17468,
+    17476, 17468, 17476, 18140, 16804, 18140, 17476, 17468, 17476, 17468, 0, 17468,
+    15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156, 15460, 19484, 15460, 19484,
+    15460, 20156, 0, 20156, 14788, 20156, 15460, 19484, 15460, 19484, 15460, 19484,
+    15460, 20156, 14788, 20156, 14788, 20156, 0, 19484, 15460, 19484, 15460, 20156,
+    14788, 20156, 14788, 20156, 0, 17468, 17476, 18140, 17476, 17468, 17476, 17468,
+    6724, 28220, 11428, 23516, 17476, 18140, 16804, 18140, 0, 17468, 17476, 17468,
+    17476, 17468, 17476, 17468, 17476, 18140, 16804, 18140, 17476, 17468, 17476, 17468,
+    0, 17468, 15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156, 15460, 19484,
+    15460, 19484, 15460, 20156, 0, 20156, 14788, 20156, 15460, 19484, 15460, 19484,
+    15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156, 0, 19484, 15460, 19484,
+    15460, 20156, 14788, 20156, 14788, 20156, 0, 17468, 17476, 18140, 17476, 17468,
+    17476, 17468, 6724, 28220, 11428, 23516, 17476, 18140, 16804, 18140, 0, 17468,
+    17476, 17468, 17476, 17468, 17476, 17468, 17476, 18140, 16804, 18140, 17476, 17468,
+    17476, 17468, 0, 17468, 15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156,
+    15460, 19484, 15460, 19484, 15460, 20156, 0, 20156, 14788, 20156, 15460, 19484,
+    15460, 19484, 15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156, 0, 19484,
+    15460, 19484, 15460, 20156, 14788, 20156, 14788, 20156, 0, 12764, 21508, 10748,
+    24292, 10076, 24196, 10076, 24868, 11420, 24196, 11420, 23524, 10748, 24868, 9404,
+    0, 12092, 22852, 12092, 22852, 11420, 22852, 12764, 22276, 14012, 21508, 12764,
+    21508, 14108, 21508, 12764, 0, 12092, 24868, 10076, 23524, 11420, 25060, 10556,
+    22852, 12092, 24868, 10748, 22180, 12092, 23524, 11420, 0, 12092, 22852, 12092,
+    22852, 12764, 22852, 11420, 23524, 11420, 23524, 12092, 22852, 12092, 22852, 12092,
+    0, 12092, 24868, 10076, 0, 0, 12764, 20164, 14780, 20836, 14108, 20836,
+    14780, 20164, 14780, 20164, 14780, 0, 11424, 23520, 12096, 22848, 12096, 22848,
+    12096, 22848, 12768, 22848, 12096, 22848, 12096, 22848, 12096, 0, 12096, 22848,
+    12096, 22848, 15456, 20160, 12096, 22848, 12096, 22848, 12096, 22848, 13440, 20832,
+    14112, 0, 14112, 21504, 13440, 21504, 12096, 22848, 12096, 22848, 12096, 22848,
+    12768, 22848, 12096, 22848, 12096, 0, 14784, 20160, 14784, 20160, 14784, 20160,
+    14784, 20832, 14112, 14784, 20160, 20832, 14784, 20160, 14784, 0, 14784, 20832,
+    14112, 20832, 14784, 20160, 14112, 20832, 0, 10752, 23520, 12768, 22848, 12096,
+    22848, 12096, 22848, 12096, 22848, 12096, 22848, 12096, 22848, 12768, 0, 12096,
+    22848, 12096, 22848, 12096, 22848, 12096, 22848, 12096, 22848, 12768, 22848, 12096,
+    20832, 15456, 0, 15456, 19488, 15456, 19488, 16128, 18816, 16128, 18816, 16128,
+    18816, 16128, 19488, 15456, 19488, 15456, 0, 16128, 18816, 16128, 18816, 16128,
+    19488, 15456, 19488, 15456, 19488, 16128, 18816, 16128, 18816, 16128, 0, 16128,
+};
+
+inline constexpr uint8_t NTP_ZONE_TYPES[] = {
+    0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81,
+    0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81,
+    0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81,
+    0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81, 0x00, 0x81,
+    0x00, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82,
+    0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x82, 0x01, 0x83, 0x04, 0x83,
+    0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83,
+    0x04, 0x83, 0x04, 0x83, 0x04, 0x84, 0x02, 0x04, 0x83, 0x04, 0x83, 0x04,
+    0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04,
+    0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04,
+    0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x83, 0x04, 0x03, 0x04,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06, 0x85, 0x06,
+    0x85, 0x06, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07, 0x86, 0x07,
+    0x86, 0x07, 0x86, 0x07, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x87, 0x08,
+    0x87, 0x08, 0x87, 0x08, 0x87, 0x08, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09,
+    0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x88, 0x09, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B, 0x8A, 0x0B,
+    0x8A, 0x0B, 0x8A, 0x0B, 0x0D, 0x8E, 0x0F, 0x8E, 0x0F, 0x8E, 0x0F, 0x8E,
+    0x0F, 0x8E, 0x0F, 0x8E, 0x0F, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x11, 0x90,
+    0x11, 0x90, 0x11, 0x90, 0x11, 0x90, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+    0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+    0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+    0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+    0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+    0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13, 0x92, 0x13,
+};
+
+inline constexpr NTPZoneEntry NTP_ZONES[NTP_ZONE_COUNT] = {
+    {"UTC", "UTC0", 0UL, 0, 0, 0, 0, 0x00},
+    {"Europe/London", "GMT0BST,M3.5.0/1,M10.5.0", 828234000UL, 0, 0, 4, 49, 0x01},
+    {"Europe/Berlin", "CET-1CEST,M3.5.0,M10.5.0/3", 828234000UL, 4, 49, 2, 32, 0x01},
+    {"Europe/Paris", "CET-1CEST,M3.5.0,M10.5.0/3", 828234000UL, 6, 81, 3, 40, 0x01},
+    {"Europe/Madrid", "CET-1CEST,M3.5.0,M10.5.0/3", 828234000UL, 9, 121, 3, 44, 0x01},
+    {"Europe/Moscow", "MSK-3", 1414274400UL, 12, 165, 5, 63, 0x04},
+    {"America/New_York", "EST5EDT,M3.2.0,M11.1.0", 1173596400UL, 17, 228, 5, 74, 0x06},
+    {"America/Chicago", "CST6CDT,M3.2.0,M11.1.0", 1173600000UL, 22, 302, 5, 74, 0x07},
+    {"America/Denver", "MST7MDT,M3.2.0,M11.1.0", 1173603600UL, 27, 376, 5, 74, 0x08},
+    {"America/Phoenix", "MST7", 0UL, 32, 450, 0, 0, 0x08},
+    {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0", 1173607200UL, 32, 450, 5, 74, 0x09},
+    {"America/Sao_Paulo", "<-03>3", 1550368800UL, 37, 524, 5, 68, 0x0B},
+    {"Asia/Kolkata", "IST-5:30", 0UL, 42, 592, 0, 0, 0x0C},
+    {"Asia/Kathmandu", "<+0545>-5:45", 504901800UL, 42, 592, 1, 1, 0x0C},
+    {"Asia/Shanghai", "CST-8", 684867600UL, 43, 593, 1, 12, 0x0F},
+    {"Asia/Tokyo", "JST-9", 0UL, 44, 605, 0, 0, 0x0E},
+    {"Australia/Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3", 1207411200UL, 44, 605, 5, 73, 0x11},
+    {"Pacific/Auckland", "NZST-12NZDT,M9.5.0,M4.1.0/3", 1191074400UL, 49, 678, 5, 66, 0x13},
+};
+
+#endif // NTP_ZONE_DATA_H
@@ -38,6 +38,33 @@ void test_ntp_packet_packed(void) {
     TEST_ASSERT_EQUAL(offsetof(NTPClient::NTPPacket, precision), 3);
 }
 
+void test_packet_view_decodes_in_place(void) {
+    uint8_t buffer[NTPPacketView::SIZE] = {0};
+    buffer[0] = (0 << 6) | (4 << 3) | 4;  // Server reply, NTPv4
+    buffer[1] = 2;
+    NTPPacketView::putWord<NTPPacketView::REFERENCE_ID>(buffer, 0x52415445);
+    NTPPacketView::putWord<NTPPacketView::ORIGIN_TIMESTAMP>(buffer, 0xE1234567);
+    NTPPacketView::putWord<NTPPacketView::TRANSMIT_TIMESTAMP + 4>(buffer, 0x80000000);
+    TEST_ASSERT_EQUAL_HEX8(0xE1, buffer[24]);  // Big-endian on the wire
+
+    NTPPacketView view(buffer);
+    TEST_ASSERT_EQUAL_UINT8(4, view.version());
+    TEST_ASSERT_EQUAL_UINT8(4, view.mode());
+    TEST_ASSERT_EQUAL_UINT8(2, view.stratum());
+    TEST_ASSERT_EQUAL_HEX32(0x52415445, view.referenceId());
+    TEST_ASSERT_EQUAL_HEX32(0xE1234567, view.originSeconds());
+    TEST_ASSERT_EQUAL_HEX32(0x80000000, view.transmitFraction());
+}
+
+void test_request_template_is_constant(void) {
+    constexpr NTPRequestTemplate request;
+    static_assert(NTPPacketView(request.bytes).mode() == 3, "Template must be a client request");
+    TEST_ASSERT_EQUAL_HEX8(0x23, request.bytes[0]);  // LI 0, VN 4, mode 3
+    for (uint8_t i = 1; i < NTPPacketView::SIZE; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0, request.bytes[i]);
+    }
+}
+
 // ============================================================================
 // SyncResult Structure Tests
 // ============================================================================
@@ -51,8 +78,9 @@ void test_sync_result_default_constructor(void) {
     TEST_ASSERT_EQUAL(0, result.roundTripMs);
     TEST_ASSERT_EQUAL(0, result.stratum);
     TEST_ASSERT_FALSE(result.success);
-    TEST_ASSERT_EQUAL('\0', result.serverUsed[0]);
-    TEST_ASSERT_EQUAL('\0', result.error[0]);
+    TEST_ASSERT_EQUAL_UINT8(NTPClient::NO_SERVER, result.serverIndex);
+    TEST_ASSERT_TRUE(result.error == NTPClient::SyncError::NONE);
+    TEST_ASSERT_EQUAL_UINT32(0, result.errorDetail);
 }
 
 void test_sync_result_usec_field(void) {
@@ -69,21 +97,27 @@ void test_sync_result_usec_field(void) {
     TEST_ASSERT_EQUAL_UINT32(500000, result.syncUsec);
 }
 
-void test_sync_result_server_buffer_size(void) {
+void test_sync_result_compact(void) {
+    // Cheap to copy and to keep a history of: no embedded strings
+    TEST_ASSERT_TRUE(sizeof(NTPClient::SyncResult) <= 32);
+}
+
+void test_sync_result_to_string(void) {
     NTPClient::SyncResult result;
+    char text[40];
 
-    // Should fit 63 chars + null
-    const char* longServer = "very-long-ntp-server-hostname.example.com";
-    strncpy(result.serverUsed, longServer, sizeof(result.serverUsed) - 1);
-    result.serverUsed[sizeof(result.serverUsed) - 1] = '\0';
+    TEST_ASSERT_EQUAL_STRING("OK", result.toString(text, sizeof(text)));
 
-    TEST_ASSERT_EQUAL(64, sizeof(result.serverUsed));
-}
+    result.error = NTPClient::SyncError::TIMEOUT;
+    TEST_ASSERT_EQUAL_STRING("Timeout waiting for NTP response", result.toString(text, sizeof(text)));
 
-void test_sync_result_error_buffer_size(void) {
-    NTPClient::SyncResult result;
+    result.error = NTPClient::SyncError::KISS_OF_DEATH;
+    result.errorDetail = NTPClient::KISS_RATE;
+    TEST_ASSERT_EQUAL_STRING("Kiss-o'-Death received: RATE", result.toString(text, sizeof(text)));
 
-    TEST_ASSERT_EQUAL(128, sizeof(result.error));
+    // Truncates safely into small buffers
+    char small[8];
+    TEST_ASSERT_EQUAL_STRING("Kiss-o'", result.toString(small, sizeof(small)));
 }
 
 // ============================================================================
@@ -91,8 +125,8 @@ void test_sync_result_error_buffer_size(void) {
 // ============================================================================
 
 void test_ntp_server_structure(void) {
-    NTPClient::NTPServer server;
-    server.hostname = "pool.ntp.org";
+    NTPClient::NTPServer server = {};
+    strncpy(server.hostname, "pool.ntp.org", sizeof(server.hostname) - 1);
     server.port = 123;
     server.lastSuccessTime = 0;
     server.failureCount = 0;
@@ -101,13 +135,75 @@ void test_ntp_server_structure(void) {
     server.reachable = true;
     server.stratum = 2;
 
-    TEST_ASSERT_EQUAL_STRING("pool.ntp.org", server.hostname.c_str());
+    TEST_ASSERT_EQUAL_STRING("pool.ntp.org", server.hostname);
     TEST_ASSERT_EQUAL_UINT16(123, server.port);
     TEST_ASSERT_EQUAL_UINT16(50, server.averageRTT);
     TEST_ASSERT_TRUE(server.reachable);
     TEST_ASSERT_EQUAL_UINT8(2, server.stratum);
 }
 
+void test_ntp_server_rto_tracks_fast_server(void) {
+    NTPClient::NTPServer server = {};
+    server.rto = NTPClient::NTPServer::INITIAL_RTO_MS;
+
+    // A LAN server answering in ~4ms converges to the minimum RTO
+    for (int i = 0; i < 20; i++) {
+        server.updateRTO(4);
+    }
+    TEST_ASSERT_EQUAL_UINT16(4, server.srtt);
+    TEST_ASSERT_EQUAL_UINT16(NTPClient::NTPServer::MIN_RTO_MS, server.rto);
+}
+
+void test_ntp_server_rto_first_sample_and_backoff(void) {
+    NTPClient::NTPServer server = {};
+
+    // First sample: SRTT = R, RTTVAR = R/2, RTO = R + 4 * R/2
+    server.updateRTO(100);
+    TEST_ASSERT_EQUAL_UINT16(100, server.srtt);
+    TEST_ASSERT_EQUAL_UINT16(50, server.rttVar);
+    TEST_ASSERT_EQUAL_UINT16(300, server.rto);
+    TEST_ASSERT_EQUAL_UINT16(200, server.rttP95());
+
+    server.backoffRTO();
+    TEST_ASSERT_EQUAL_UINT16(600, server.rto);
+
+    // Backoff saturates at the maximum
+    for (int i = 0; i < 10; i++) {
+        server.backoffRTO();
+    }
+    TEST_ASSERT_EQUAL_UINT16(NTPClient::NTPServer::MAX_RTO_MS, server.rto);
+}
+
+void test_kiss_code_to_string(void) {
+    char code[5];
+
+    NTPClient::kissCodeToString(NTPClient::KISS_RATE, code);
+    TEST_ASSERT_EQUAL_STRING("RATE", code);
+    NTPClient::kissCodeToString(NTPClient::KISS_DENY, code);
+    TEST_ASSERT_EQUAL_STRING("DENY", code);
+    NTPClient::kissCodeToString(NTPClient::KISS_RSTR, code);
+    TEST_ASSERT_EQUAL_STRING("RSTR", code);
+
+    // Non-printable bytes are masked
+    NTPClient::kissCodeToString(0x41000142UL, code);
+    TEST_ASSERT_EQUAL_STRING("A??B", code);
+}
+
+void test_ntp_server_usable_respects_kiss_state(void) {
+    NTPClient::NTPServer server = {};
+    server.reachable = true;
+    TEST_ASSERT_TRUE(server.usable(1000));
+
+    // Rate-limited: skipped until the holdoff expires
+    server.rateBackoff = 1;
+    server.holdoffUntilMs = 5000;
+    TEST_ASSERT_FALSE(server.usable(1000));
+    TEST_ASSERT_TRUE(server.usable(5000));
+
+    server.denied = true;
+    TEST_ASSERT_FALSE(server.usable(6000));
+}
+
 // ============================================================================
 // TimeZoneConfig Structure Tests
 // ============================================================================
@@ -115,7 +211,7 @@ void test_ntp_server_structure(void) {
 void test_timezone_config_structure(void) {
     NTPClient::TimeZoneConfig tz;
     tz.offsetMinutes = -300;  // EST = UTC-5
-    tz.name = "EST";
+    strncpy(tz.name, "EST", sizeof(tz.name));
     tz.useDST = true;
     tz.dstStartWeek = 2;
     tz.dstStartMonth = 3;
@@ -128,7 +224,7 @@ void test_timezone_config_structure(void) {
     tz.dstOffsetMinutes = 60;
 
     TEST_ASSERT_EQUAL_INT16(-300, tz.offsetMinutes);
-    TEST_ASSERT_EQUAL_STRING("EST", tz.name.c_str());
+    TEST_ASSERT_EQUAL_STRING("EST", tz.name);
     TEST_ASSERT_TRUE(tz.useDST);
     TEST_ASSERT_EQUAL_UINT8(2, tz.dstStartWeek);
 }
@@ -169,6 +265,389 @@ void test_timezone_cet(void) {
     TEST_ASSERT_EQUAL_UINT8(10, cet.dstEndMonth);    // October
 }
 
+void test_dst_lookup_across_years(void) {
+    NTPClient client;
+    client.setTimeZone(NTPClient::getTimeZoneEST());
+
+    // Second Sunday of March to first Sunday of November, 2 AM local
+    // (07:00 UTC on standard time, 06:00 UTC on daylight time)
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2024, 1, 15, 12, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 7, 1, 12, 0, 0)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2024, 3, 10, 6, 59, 59)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 3, 10, 7, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 11, 3, 5, 59, 59)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2024, 11, 3, 6, 0, 0)));
+
+    // Years outside the cached range are recomputed on demand
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2031, 3, 9, 7, 0, 0)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2031, 3, 9, 6, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 7, 1, 12, 0, 0)));
+
+    // Southern-hemisphere rule wraps around the new year
+    NTPClient::TimeZoneConfig south = NTPClient::getTimeZoneUTC();
+    south.useDST = true;
+    south.dstStartWeek = 1; south.dstStartMonth = 10; south.dstStartDayOfWeek = 0; south.dstStartHour = 2;
+    south.dstEndWeek = 1;   south.dstEndMonth = 4;    south.dstEndDayOfWeek = 0;   south.dstEndHour = 3;
+    client.setTimeZone(south);
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2025, 1, 1, 0, 0, 0)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2025, 6, 1, 0, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2025, 12, 31, 23, 59, 59)));
+}
+
+void test_posix_tz_parses_rules(void) {
+    NTPClient::TimeZoneConfig tz;
+    TEST_ASSERT_TRUE(NTPClient::parseTimeZone("CET-1CEST,M3.5.0,M10.5.0/3", tz));
+    TEST_ASSERT_EQUAL_STRING("CET", tz.name);
+    TEST_ASSERT_EQUAL_INT16(60, tz.offsetMinutes);
+    TEST_ASSERT_TRUE(tz.useDST);
+    TEST_ASSERT_EQUAL_INT16(60, tz.dstOffsetMinutes);
+    TEST_ASSERT_EQUAL_UINT8(5, tz.dstStartWeek);
+    TEST_ASSERT_EQUAL_UINT8(3, tz.dstStartMonth);
+    TEST_ASSERT_EQUAL_INT16(2, tz.dstStartHour);   // Default transition time
+    TEST_ASSERT_EQUAL_UINT8(10, tz.dstEndMonth);
+    TEST_ASSERT_EQUAL_INT16(3, tz.dstEndHour);
+
+    // Quoted names, minute offsets, explicit DST offset and Jn/n dates
+    TEST_ASSERT_TRUE(NTPClient::parseTimeZone("<+0545>-5:45", tz));
+    TEST_ASSERT_EQUAL_STRING("+0545", tz.name);
+    TEST_ASSERT_EQUAL_INT16(345, tz.offsetMinutes);
+    TEST_ASSERT_FALSE(tz.useDST);
+
+    TEST_ASSERT_TRUE(NTPClient::parseTimeZone("AAA3BBB2,J60/-1:30,300/25", tz));
+    TEST_ASSERT_EQUAL_INT16(-180, tz.offsetMinutes);
+    TEST_ASSERT_EQUAL_INT16(60, tz.dstOffsetMinutes);
+    TEST_ASSERT_TRUE(tz.dstStartRule == NTPClient::DST_RULE_JULIAN_DAY);
+    TEST_ASSERT_EQUAL_UINT16(60, tz.dstStartDay);
+    TEST_ASSERT_EQUAL_INT16(-1, tz.dstStartHour);
+    TEST_ASSERT_EQUAL_INT8(-30, tz.dstStartMinute);
+    TEST_ASSERT_TRUE(tz.dstEndRule == NTPClient::DST_RULE_DAY_OF_YEAR);
+    TEST_ASSERT_EQUAL_UINT16(300, tz.dstEndDay);
+    TEST_ASSERT_EQUAL_INT16(25, tz.dstEndHour);
+
+    // DST name without a rule falls back to the US rules
+    TEST_ASSERT_TRUE(NTPClient::parseTimeZone("EST5EDT", tz));
+    TEST_ASSERT_EQUAL_INT16(-300, tz.offsetMinutes);
+    TEST_ASSERT_EQUAL_UINT8(3, tz.dstStartMonth);
+    TEST_ASSERT_EQUAL_UINT8(11, tz.dstEndMonth);
+}
+
+void test_posix_tz_rejects_malformed(void) {
+    NTPClient::TimeZoneConfig tz;
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone(nullptr, tz));
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("", tz));
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("CE-1", tz));                     // Name too short
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("CET", tz));                      // Missing offset
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("CET-1CEST,M13.5.0,M10.5.0", tz)); // Bad month
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("CET-1CEST,M3.5.0", tz));         // Missing end
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("CET-1CEST,M3.5.0,M10.5.0/3x", tz));
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone("<ABC", tz));
+    TEST_ASSERT_FALSE(NTPClient::parseTimeZone(":Europe/Berlin", tz));
+
+    NTPClient client;
+    TEST_ASSERT_FALSE(client.setTimeZone("bogus"));
+    TEST_ASSERT_EQUAL_STRING("UTC", client.getTimeZone().name);  // Unchanged
+}
+
+void test_posix_tz_transitions(void) {
+    NTPClient client;
+    TEST_ASSERT_TRUE(client.setTimeZone("CET-1CEST,M3.5.0,M10.5.0/3"));
+
+    // Both EU transitions happen at 01:00 UTC
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2025, 3, 30, 0, 59, 59)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2025, 3, 30, 1, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2025, 10, 26, 0, 59, 59)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2025, 10, 26, 1, 0, 0)));
+
+    // J60 is March 1 even in leap years; n counts February 29
+    TEST_ASSERT_TRUE(client.setTimeZone("XXX0YYY,J60/0,200/0"));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2024, 2, 29, 23, 59, 59)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 3, 1, 0, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2024, 7, 18, 22, 59, 59)));
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(2024, 7, 18, 23, 0, 0)));  // Day 200 at 00:00 DST
+}
+
+void test_compiled_zone_lookup(void) {
+    NTPClient::ZoneInterval zone;
+
+    // Table: Moscow used UTC+4 all year between 2011 and 2014
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_EUROPE_MOSCOW, NTPClient::makeTime(2013, 1, 1, 0, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(240, zone.offsetMinutes);
+    TEST_ASSERT_FALSE(zone.dst);
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_EUROPE_MOSCOW, NTPClient::makeTime(2020, 1, 1, 0, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(180, zone.offsetMinutes);
+
+    // Table: pre-2007 US rules (first Sunday in April, 2 AM EST = 07:00 UTC)
+    time_t start2006 = NTPClient::makeTime(2006, 4, 2, 7, 0, 0);
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_AMERICA_NEW_YORK, start2006 - 1, zone));
+    TEST_ASSERT_EQUAL_INT16(-300, zone.offsetMinutes);
+    TEST_ASSERT_TRUE(zone.until == start2006);
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_AMERICA_NEW_YORK, start2006, zone));
+    TEST_ASSERT_EQUAL_INT16(-240, zone.offsetMinutes);
+    TEST_ASSERT_TRUE(zone.dst);
+    TEST_ASSERT_TRUE(zone.from == start2006);
+
+    // Rule: current US and southern-hemisphere DST
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_AMERICA_NEW_YORK, NTPClient::makeTime(2024, 3, 10, 7, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(-240, zone.offsetMinutes);
+    TEST_ASSERT_TRUE(zone.until == NTPClient::makeTime(2024, 11, 3, 6, 0, 0));
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_AUSTRALIA_SYDNEY, NTPClient::makeTime(2025, 1, 1, 0, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(660, zone.offsetMinutes);
+
+    // Fixed offsets, including the 1986 Kathmandu change to +05:45
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_ASIA_KATHMANDU, NTPClient::makeTime(1980, 1, 1, 0, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(330, zone.offsetMinutes);
+    TEST_ASSERT_TRUE(NTPClient::lookupZone(NTP_ZONE_ASIA_KATHMANDU, NTPClient::makeTime(1990, 1, 1, 0, 0, 0), zone));
+    TEST_ASSERT_EQUAL_INT16(345, zone.offsetMinutes);
+
+    TEST_ASSERT_FALSE(NTPClient::lookupZone(NTP_ZONE_NONE, 0, zone));
+}
+
+void test_client_uses_compiled_zone(void) {
+    TEST_ASSERT_EQUAL(NTP_ZONE_EUROPE_BERLIN, NTPClient::findZone("Europe/Berlin"));
+    TEST_ASSERT_EQUAL(NTP_ZONE_NONE, NTPClient::findZone("Mars/Olympus_Mons"));
+    TEST_ASSERT_EQUAL_STRING("Europe/Berlin", NTPClient::getZoneName(NTP_ZONE_EUROPE_BERLIN));
+
+    NTPClient client;
+    TEST_ASSERT_FALSE(client.setTimeZone(NTP_ZONE_NONE));
+    TEST_ASSERT_TRUE(client.setTimeZone(NTP_ZONE_EUROPE_BERLIN));
+    TEST_ASSERT_EQUAL(NTP_ZONE_EUROPE_BERLIN, client.getTimeZoneId());
+    TEST_ASSERT_EQUAL_STRING("CET", client.getTimeZone().name);
+
+    // No DST in West Germany before 1980; the rule alone would say otherwise
+    TEST_ASSERT_FALSE(client.isDST(NTPClient::makeTime(1979, 7, 1, 12, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(1990, 7, 1, 12, 0, 0)));
+    TEST_ASSERT_TRUE(client.isDST(NTPClient::makeTime(2025, 7, 1, 12, 0, 0)));
+
+    // A rule-based zone replaces the compiled one
+    client.setTimeZone(NTPClient::getTimeZoneEST());
+    TEST_ASSERT_EQUAL(NTP_ZONE_NONE, client.getTimeZoneId());
+}
+
+void test_time_zone_handles_independent(void) {
+    const NTPTimeZone tokyo(NTP_ZONE_ASIA_TOKYO);
+    const NTPTimeZone newYork(NTP_ZONE_AMERICA_NEW_YORK);
+    NTPTimeZone sydney;
+    TEST_ASSERT_TRUE(NTPTimeZone::fromPosix("AEST-10AEDT,M10.1.0,M4.1.0/3", sydney));
+    TEST_ASSERT_FALSE(NTPTimeZone::fromPosix("AEST-10AEDT,M10.1.0", sydney));
+
+    // One instant rendered in three zones, none of them the client's
+    time_t utc = NTPClient::makeTime(2024, 7, 1, 12, 0, 0);
+    char buffer[32];
+    TEST_ASSERT_EQUAL(19, NTPClient::formatLocal(utc, tokyo, buffer));
+    TEST_ASSERT_EQUAL_STRING("2024-07-01 21:00:00", buffer);
+    NTPClient::formatLocal(utc, newYork, buffer, sizeof(buffer), "%H:%M");
+    TEST_ASSERT_EQUAL_STRING("08:00", buffer);
+    TEST_ASSERT_TRUE(NTPClient::toLocal(utc, sydney) == utc + 10 * 3600);
+    TEST_ASSERT_EQUAL(0, NTPClient::formatLocal(utc, tokyo, buffer, 4));
+
+    // Each handle keeps the interval of its last lookup
+    const NTPTimeZone::Interval& cached = newYork.at(utc);
+    TEST_ASSERT_TRUE(cached.from == NTPClient::makeTime(2024, 3, 10, 7, 0, 0));
+    TEST_ASSERT_TRUE(cached.until == NTPClient::makeTime(2024, 11, 3, 6, 0, 0));
+    TEST_ASSERT_EQUAL_INT16(-300, newYork.offsetMinutes(cached.until));
+}
+
+void test_rfc3339_formatting(void) {
+    char buffer[NTPFormat::RFC3339_MAX_LENGTH + 1];
+    time_t utc = NTPClient::makeTime(2024, 7, 1, 12, 0, 5);
+
+    TEST_ASSERT_EQUAL(20, NTPFormat::rfc3339(utc, 0, 0, 0, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("2024-07-01T12:00:05Z", buffer);
+    TEST_ASSERT_EQUAL(29, NTPFormat::rfc3339(utc, 123456789, 120, 3, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("2024-07-01T14:00:05.123+02:00", buffer);
+    TEST_ASSERT_EQUAL(35, NTPFormat::rfc3339(utc, 7, -570, 9, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_STRING("2024-07-01T02:30:05.000000007-09:30", buffer);
+
+    // Offset crosses midnight and the year boundary
+    NTPFormat::rfc3339(NTPClient::makeTime(2023, 12, 31, 23, 0, 0), 0, 345, 0, buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("2024-01-01T04:45:00+05:45", buffer);
+
+    // Too small for the text plus the null
+    TEST_ASSERT_EQUAL(0, NTPFormat::rfc3339(utc, 0, 0, 0, buffer, 20));
+
+    const NTPTimeZone newYork(NTP_ZONE_AMERICA_NEW_YORK);
+    TEST_ASSERT_EQUAL(27, NTPClient::formatRFC3339(utc, 500000000, newYork, buffer, sizeof(buffer), 1));
+    TEST_ASSERT_EQUAL_STRING("2024-07-01T08:00:05.5-04:00", buffer);
+
+    NTPClient client;
+    client.setEpochTime(utc);
+    TEST_ASSERT_EQUAL(24, client.formatRFC3339(buffer));
+    TEST_ASSERT_EQUAL_STRING_LEN("2024-07-01T12:00:0", buffer, 18);
+    TEST_ASSERT_EQUAL('Z', buffer[23]);
+}
+
+void test_format_memo_steps_in_place(void) {
+    NTPFormatMemo memo;
+    char expected[NTPFormat::RFC3339_MAX_LENGTH + 1];
+    char actual[NTPFormat::RFC3339_MAX_LENGTH + 1];
+
+    // Seconds, minute, hour and day rollovers, a jump back and a jump ahead
+    time_t start = NTPClient::makeTime(2024, 2, 28, 23, 58, 57);
+    const int32_t steps[] = {0, 0, 1, 1, 1, 59, 3600, 3, -10, 86400 * 400};
+    time_t utc = start;
+    for (int32_t step : steps) {
+        utc += step;
+        NTPFormat::format(utc, 250000000, 60, NTPTimeFormat::RFC3339_MILLIS, expected, sizeof(expected));
+        TEST_ASSERT_EQUAL(29, memo.format(utc, 250000000, 60, NTPTimeFormat::RFC3339_MILLIS,
+                                          actual, sizeof(actual)));
+        TEST_ASSERT_EQUAL_STRING(expected, actual);
+    }
+
+    // All layouts are slices of the memoized text
+    utc = NTPClient::makeTime(2024, 1, 15, 14, 30, 45);
+    memo.format(utc, 0, 0, NTPTimeFormat::TIME, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING("14:30:45", actual);
+    memo.format(utc, 0, 0, NTPTimeFormat::DATE, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING("2024-01-15", actual);
+    memo.format(utc, 0, 0, NTPTimeFormat::DATE_TIME, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING("2024-01-15 14:30:45", actual);
+    memo.format(utc, 0, 0, NTPTimeFormat::RFC3339, actual, sizeof(actual));
+    TEST_ASSERT_EQUAL_STRING("2024-01-15T14:30:45Z", actual);
+    TEST_ASSERT_EQUAL(0, memo.format(utc, 0, 0, NTPTimeFormat::DATE, actual, 10));
+
+    NTPClient client;
+    client.setEpochTime(utc);
+    TEST_ASSERT_EQUAL_STRING_LEN("2024-01-15 14:30:4", client.getFormattedDateTime(), 18);
+    TEST_ASSERT_EQUAL_STRING("2024-01-15", client.getFormattedDate());
+}
+
+void test_format_time_into_caller_buffer(void) {
+    NTPClient client;
+    client.setTimeZone(NTP_ZONE_ASIA_TOKYO);
+    client.setEpochTime(NTPClient::makeTime(2024, 1, 15, 5, 30, 45));
+
+    // The shared buffer is left alone
+    const char* shared = client.getFormattedDate();
+    char buffer[40];
+    TEST_ASSERT_EQUAL(8, client.formatTime(buffer, sizeof(buffer), NTPTimeFormat::TIME));
+    TEST_ASSERT_EQUAL_STRING_LEN("14:30:4", buffer, 7);
+    TEST_ASSERT_EQUAL(25, client.formatTime(buffer, NTPTimeFormat::RFC3339));
+    TEST_ASSERT_EQUAL_STRING_LEN("2024-01-15T14:30:4", buffer, 18);
+    TEST_ASSERT_EQUAL_STRING("+09:00", buffer + 19);
+    TEST_ASSERT_EQUAL_STRING("2024-01-15", shared);
+
+    TEST_ASSERT_EQUAL(10, client.formatTime(buffer, sizeof(buffer), "%d.%m.%Y"));
+    TEST_ASSERT_EQUAL_STRING("15.01.2024", buffer);
+    TEST_ASSERT_EQUAL(0, client.formatTime(buffer, 8, NTPTimeFormat::TIME));
+    TEST_ASSERT_EQUAL(0, client.formatTime(buffer, 4, "%Y-%m-%d"));
+    TEST_ASSERT_EQUAL('\0', buffer[0]);
+
+    NTPClient::FormattedTime text = client.formatTime();
+    TEST_ASSERT_EQUAL(19, strlen(text.data()));
+    TEST_ASSERT_EQUAL_STRING_LEN("2024-01-15 14:30:4", text.data(), 18);
+}
+
+static constexpr char ISO_FORMAT[] = "%Y-%m-%dT%H:%M:%S";
+static constexpr char VERBOSE_FORMAT[] = "%a %d %b %Y, %I:%M %p (day %j, UTC%z) %%";
+
+void test_fixed_format_compiles_fields(void) {
+    static_assert(NTPFixedFormat<ISO_FORMAT>::LENGTH == 19, "ISO length");
+    static_assert(NTPFixedFormat<ISO_FORMAT>::FIELD_COUNT == 11, "ISO fields");
+    static_assert(NTPFixedFormat<ISO_FORMAT>::FIELDS[1].literal == '-', "Separator");
+
+    char iso[NTPFixedFormat<ISO_FORMAT>::LENGTH + 1];
+    time_t utc = NTPClient::makeTime(2024, 2, 29, 23, 5, 9);
+    TEST_ASSERT_EQUAL(19, NTPFixedFormat<ISO_FORMAT>::format(utc, 0, iso));
+    TEST_ASSERT_EQUAL_STRING("2024-02-29T23:05:09", iso);
+
+    char verbose[64];
+    TEST_ASSERT_EQUAL(NTPFixedFormat<VERBOSE_FORMAT>::LENGTH,
+                      NTPFixedFormat<VERBOSE_FORMAT>::format(utc, -330, verbose));
+    TEST_ASSERT_EQUAL_STRING("Thu 29 Feb 2024, 05:35 PM (day 060, UTC-0530) %", verbose);
+
+    // Same text as strftime() for the conversions both support
+    struct tm timeinfo;
+    NTPCalendar::toTm(utc - 330 * 60, timeinfo);
+    char expected[64];
+    strftime(expected, sizeof(expected), "%a %d %b %Y, %I:%M %p (day %j", &timeinfo);
+    TEST_ASSERT_EQUAL_STRING_LEN(expected, verbose, strlen(expected));
+
+    NTPClient client;
+    client.setEpochTime(utc);
+    TEST_ASSERT_EQUAL(19, client.formatTime<ISO_FORMAT>(iso));
+    TEST_ASSERT_EQUAL_STRING_LEN("2024-02-29T23:05:", iso, 17);
+}
+
+void test_batch_conversion(void) {
+    const NTPTimeZone berlin(NTP_ZONE_EUROPE_BERLIN);
+
+    // Sorted log timestamps across the spring-forward gap and a day change
+    const time_t utc[] = {
+        NTPClient::makeTime(2024, 3, 30, 22, 59, 59),
+        NTPClient::makeTime(2024, 3, 30, 23, 0, 0),
+        NTPClient::makeTime(2024, 3, 31, 0, 59, 59),
+        NTPClient::makeTime(2024, 3, 31, 1, 0, 0),
+        NTPClient::makeTime(2024, 3, 31, 1, 0, 1),
+    };
+    const size_t count = sizeof(utc) / sizeof(utc[0]);
+
+    NTPCivilTime civil[count];
+    berlin.toCivil(utc, count, civil);
+    for (size_t i = 0; i < count; i++) {
+        NTPCivilTime expected = NTPCalendar::fromEpoch(berlin.toLocal(utc[i]));
+        TEST_ASSERT_EQUAL(expected.day, civil[i].day);
+        TEST_ASSERT_EQUAL(expected.hour, civil[i].hour);
+        TEST_ASSERT_EQUAL(expected.weekday, civil[i].weekday);
+        TEST_ASSERT_EQUAL(expected.yearDay, civil[i].yearDay);
+    }
+
+    char text[128];
+    TEST_ASSERT_EQUAL(count, NTPClient::formatBatch(utc, count, berlin, NTPTimeFormat::DATE_TIME,
+                                                    text, sizeof(text)));
+    TEST_ASSERT_EQUAL_STRING("2024-03-30 23:59:59\n2024-03-31 00:00:00\n2024-03-31 01:59:59\n"
+                             "2024-03-31 03:00:00\n2024-03-31 03:00:01", text);
+
+    // Stops at the last entry that fits, without a trailing separator
+    TEST_ASSERT_EQUAL(2, NTPClient::formatBatch(utc, count, berlin, NTPTimeFormat::TIME,
+                                                text, 20, ','));
+    TEST_ASSERT_EQUAL_STRING("23:59:59,00:00:00", text);
+}
+
+void test_rfc3339_parsing(void) {
+    time_t utc;
+    uint32_t nanos;
+
+    TEST_ASSERT_TRUE(NTPClient::parseTime("2024-07-01T12:00:05Z", utc, nanos));
+    TEST_ASSERT_TRUE(utc == NTPClient::makeTime(2024, 7, 1, 12, 0, 5));
+    TEST_ASSERT_EQUAL_UINT32(0, nanos);
+    TEST_ASSERT_TRUE(NTPClient::parseTime("2024-07-01t14:00:05.123456789123+02:00", utc, nanos));
+    TEST_ASSERT_TRUE(utc == NTPClient::makeTime(2024, 7, 1, 12, 0, 5));
+    TEST_ASSERT_EQUAL_UINT32(123456789, nanos);
+    TEST_ASSERT_TRUE(NTPClient::parseTime("2024-06-30 21:15:05,5-0545", utc, nanos));
+    TEST_ASSERT_TRUE(utc == NTPClient::makeTime(2024, 7, 1, 3, 0, 5));
+    TEST_ASSERT_EQUAL_UINT32(500000000, nanos);
+    TEST_ASSERT_TRUE(NTPClient::parseTime("2024-02-29", utc));
+    TEST_ASSERT_TRUE(utc == NTPClient::makeTime(2024, 2, 29, 0, 0, 0));
+    TEST_ASSERT_TRUE(NTPClient::parseTime("2016-12-31T23:59:60Z", utc));
+    TEST_ASSERT_TRUE(utc == NTPClient::makeTime(2017, 1, 1, 0, 0, 0));
+
+    const char* malformed[] = {
+        "", "2024", "2024-7-01", "2023-02-29", "2024-13-01", "2024-07-01T", "2024-07-01T24:00:00Z",
+        "2024-07-01T12:60", "2024-07-01T12:00:00.", "2024-07-01T12:00:00+2:00", "2024-07-01T12:00:00Z ",
+        "2024-07-01T12:00:00+24:00", "2024-07-01X12:00:00"
+    };
+    utc = 42;
+    for (const char* text : malformed) {
+        TEST_ASSERT_FALSE(NTPClient::parseTime(text, utc));
+    }
+    TEST_ASSERT_FALSE(NTPClient::parseTime(nullptr, utc));
+    TEST_ASSERT_TRUE(utc == 42);
+
+    // Instants time_t cannot hold are rejected, not truncated
+    bool wideTime = sizeof(time_t) >= 8;
+    TEST_ASSERT_EQUAL(wideTime, NTPClient::parseTime("1900-01-01T00:00:00Z", utc));
+    TEST_ASSERT_EQUAL(wideTime, NTPClient::parseTime("2040-01-01T00:00:00Z", utc));
+    TEST_ASSERT_TRUE(!wideTime || (int64_t)utc == NTPCalendar::toEpoch(2040, 1, 1, 0, 0, 0));
+
+    // Round trip through the formatter
+    char text[NTPFormat::RFC3339_MAX_LENGTH + 1];
+    int64_t parsed;
+    NTPFormat::rfc3339(1893456000, 987654321, -210, 9, text, sizeof(text));
+    TEST_ASSERT_TRUE(NTPFormat::parseRFC3339(text, parsed, nanos));
+    TEST_ASSERT_TRUE(parsed == 1893456000);
+    TEST_ASSERT_EQUAL_UINT32(987654321, nanos);
+}
+
 // ============================================================================
 // Static Utility Method Tests
 // ============================================================================
@@ -241,6 +720,20 @@ void test_make_time_2024(void) {
     TEST_ASSERT_EQUAL(1704067200, epoch);
 }
 
+void test_make_time_normalizes_fields(void) {
+    // Negative fields borrow from the next larger unit
+    TEST_ASSERT_EQUAL(1704065400, NTPClient::makeTime(2024, 1, 1, 0, -30, 0));
+    TEST_ASSERT_EQUAL(1704067170, NTPClient::makeTime(2024, 1, 1, 0, 0, -30));
+    TEST_ASSERT_EQUAL(NTPClient::makeTime(2023, 12, 31, 0, 0, 0), NTPClient::makeTime(2024, 1, 0, 0, 0, 0));
+    TEST_ASSERT_EQUAL(NTPClient::makeTime(2023, 11, 1, 0, 0, 0), NTPClient::makeTime(2024, -1, 1, 0, 0, 0));
+
+    // Overflowing fields carry into the next larger unit
+    TEST_ASSERT_EQUAL(1705147200, NTPClient::makeTime(2024, 1, 1, 300, 0, 0));
+    TEST_ASSERT_EQUAL(NTPClient::makeTime(2024, 3, 1, 0, 0, 0), NTPClient::makeTime(2024, 2, 30, 0, 0, 0));
+    TEST_ASSERT_EQUAL(NTPClient::makeTime(2025, 2, 1, 0, 0, 0), NTPClient::makeTime(2024, 14, 1, 0, 0, 0));
+    TEST_ASSERT_EQUAL(NTPClient::makeTime(2024, 7, 1, 12, 1, 30), NTPClient::makeTime(2024, 7, 1, 12, 0, 90));
+}
+
 void test_epoch_to_string_format(void) {
     // Test with a known epoch
     time_t epoch = 946684800;  // 2000-01-01 00:00:00
@@ -249,6 +742,45 @@ void test_epoch_to_string_format(void) {
     TEST_ASSERT_EQUAL_STRING("2000-01-01", result.c_str());
 }
 
+void test_calendar_round_trip(void) {
+    static_assert(NTPCalendar::daysFromCivil(1970, 1, 1) == 0, "Epoch is day zero");
+    static_assert(NTPCalendar::toEpoch(2038, 1, 19, 3, 14, 8) == 2147483648LL, "Past 32-bit time_t");
+    static_assert(NTPCalendar::weekdayFromDays(0) == 4, "1970-01-01 was a Thursday");
+
+    NTPCivilTime leap = NTPCalendar::fromEpoch(NTPCalendar::toEpoch(2024, 2, 29, 23, 59, 59));
+    TEST_ASSERT_EQUAL_INT32(2024, leap.year);
+    TEST_ASSERT_EQUAL_UINT8(2, leap.month);
+    TEST_ASSERT_EQUAL_UINT8(29, leap.day);
+    TEST_ASSERT_EQUAL_UINT8(23, leap.hour);
+    TEST_ASSERT_EQUAL_UINT8(59, leap.second);
+    TEST_ASSERT_EQUAL_UINT8(4, leap.weekday);  // Thursday
+    TEST_ASSERT_EQUAL_UINT16(59, leap.yearDay);
+
+    NTPCivilTime before = NTPCalendar::fromEpoch(-1);
+    TEST_ASSERT_EQUAL_INT32(1969, before.year);
+    TEST_ASSERT_EQUAL_UINT8(12, before.month);
+    TEST_ASSERT_EQUAL_UINT8(31, before.day);
+    TEST_ASSERT_EQUAL_UINT8(3, before.weekday);  // Wednesday
+
+    // Every day of four centuries survives the round trip
+    for (int64_t days = -146097; days < 146097; days += 7) {
+        NTPCivilTime civil = NTPCalendar::civilFromDays(days);
+        TEST_ASSERT_TRUE(NTPCalendar::daysFromCivil(civil.year, civil.month, civil.day) == days);
+    }
+}
+
+void test_make_time_ignores_tz_environment(void) {
+    setenv("TZ", "EST5EDT", 1);
+    tzset();
+    time_t epoch = NTPClient::makeTime(2024, 1, 1, 0, 0, 0);
+    String text = NTPClient::epochToString(epoch, "%H:%M");
+    unsetenv("TZ");
+    tzset();
+
+    TEST_ASSERT_EQUAL(1704067200, epoch);
+    TEST_ASSERT_EQUAL_STRING("00:00", text.c_str());
+}
+
 // ============================================================================
 // NTP Fractional Seconds Conversion Tests
 // ============================================================================
@@ -422,6 +954,31 @@ void test_client_get_servers_empty_initially(void) {
     TEST_ASSERT_TRUE(servers.empty());
 }
 
+void test_client_server_table_fixed_capacity(void) {
+    NTPClient client;
+
+    char longName[NTPClient::MAX_HOSTNAME_LENGTH + 2];
+    memset(longName, 'a', sizeof(longName) - 1);
+    longName[sizeof(longName) - 1] = '\0';
+    TEST_ASSERT_FALSE(client.addServer(longName));  // One char too long
+
+    TEST_ASSERT_TRUE(client.addServer("a.example.com"));
+    TEST_ASSERT_TRUE(client.addServer("b.example.com", 1123));
+    TEST_ASSERT_TRUE(client.addServer("c.example.com"));
+    TEST_ASSERT_TRUE(client.removeServer("b.example.com"));
+    TEST_ASSERT_EQUAL_UINT8(2, client.getServerCount());
+    TEST_ASSERT_EQUAL_STRING("c.example.com", client.getServer(1)->hostname);
+    TEST_ASSERT_NULL(client.getServer(2));
+
+    uint8_t visited = 0;
+    for (const auto& server : client.getServers()) {
+        TEST_ASSERT_EQUAL_UINT16(123, server.port);
+        visited++;
+    }
+    client.forEachServer([&visited](const NTPClient::NTPServer&) { visited++; });
+    TEST_ASSERT_EQUAL_UINT8(4, visited);
+}
+
 void test_client_timezone_default(void) {
     NTPClient client;
 
@@ -440,6 +997,711 @@ void test_client_reset_statistics(void) {
     TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, client.getAverageSyncTime());
 }
 
+// ============================================================================
+// Custom Transport Tests
+// ============================================================================
+
+// Minimal UDP transport that records what the client sends and never answers
+struct RecordingUdp {
+    uint16_t lastPort = 0;
+    size_t lastLength = 0;
+    uint8_t sent = 0;
+    uint8_t packet[48] = {0};
+
+    uint8_t begin(uint16_t) { return 1; }
+    void stop() {}
+    int beginPacket(const char*, uint16_t port) { lastPort = port; return 1; }
+    size_t write(const uint8_t* data, size_t length) {
+        lastLength = length;
+        memcpy(packet, data, length < sizeof(packet) ? length : sizeof(packet));
+        return length;
+    }
+    int endPacket() { sent++; return 1; }
+    int parsePacket() { return 0; }
+    int read(uint8_t*, size_t) { return 0; }
+};
+
+using TinyClient = BasicNTPClient<RecordingUdp, 2>;
+
+// Simulated millisecond counter; delay() just moves it forward
+struct FakeClock {
+    static uint32_t now;
+    static uint32_t millis() { return now; }
+    static void delay(uint32_t ms) { now += ms; }
+};
+uint32_t FakeClock::now = 0;
+
+// UDP transport backed by scripted servers: each host answers after a fixed
+// delay of FakeClock time (or never), optionally with a Kiss-o'-Death, and
+// can charge a DNS lookup delay to beginPacket()
+struct ScriptedUdp {
+    static constexpr uint8_t MAX_HOSTS = 4;
+    static constexpr int32_t SILENT = -1;
+
+    struct Host {
+        const char* name = nullptr;
+        int32_t replyAfterMs = SILENT;
+        uint32_t lookupMs = 0;
+        uint32_t kissCode = 0;
+        uint16_t sent = 0;
+    };
+    struct Reply {
+        bool queued = false;
+        uint32_t dueMs = 0;
+        uint8_t packet[48];
+    };
+
+    Host hosts[MAX_HOSTS];
+    Reply replies[8];
+    Host* current = nullptr;
+    uint8_t request[48];
+    uint8_t ready = 0xFF;
+    uint16_t sent = 0;
+
+    Host& host(const char* name) {
+        for (Host& h : hosts) {
+            if (h.name == nullptr || strcmp(h.name, name) == 0) {
+                h.name = name;
+                return h;
+            }
+        }
+        return hosts[MAX_HOSTS - 1];
+    }
+
+    uint8_t begin(uint16_t) { return 1; }
+    void stop() {}
+    int beginPacket(const char* address, uint16_t) {
+        current = &host(address);
+        FakeClock::now += current->lookupMs;
+        return 1;
+    }
+    size_t write(const uint8_t* data, size_t length) {
+        memcpy(request, data, length < sizeof(request) ? length : sizeof(request));
+        return length;
+    }
+    int endPacket() {
+        sent++;
+        current->sent++;
+        if (current->replyAfterMs == SILENT) return 1;
+        for (Reply& reply : replies) {
+            if (reply.queued) continue;
+            memset(reply.packet, 0, sizeof(reply.packet));
+            reply.packet[0] = (4 << 3) | 4;
+            reply.packet[NTPPacketView::STRATUM] = current->kissCode ? 0 : 2;
+            NTPPacketView::putWord<NTPPacketView::REFERENCE_ID>(reply.packet, current->kissCode);
+            memcpy(reply.packet + NTPPacketView::ORIGIN_TIMESTAMP,
+                   request + NTPPacketView::TRANSMIT_TIMESTAMP, 8);
+            // The present as transmit time, so applying it barely moves the clock
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            NTPPacketView::putWord<NTPPacketView::TRANSMIT_TIMESTAMP>(
+                reply.packet, (uint32_t)(now.tv_sec + 2208988800UL));
+            NTPPacketView::putWord<NTPPacketView::TRANSMIT_TIMESTAMP + 4>(
+                reply.packet, (uint32_t)(((uint64_t)now.tv_usec << 32) / 1000000));
+            reply.dueMs = FakeClock::now + current->replyAfterMs;
+            reply.queued = true;
+            break;
+        }
+        return 1;
+    }
+    int parsePacket() {
+        ready = 0xFF;
+        for (uint8_t i = 0; i < 8; i++) {
+            if (replies[i].queued && (int32_t)(FakeClock::now - replies[i].dueMs) >= 0 &&
+                (ready == 0xFF || (int32_t)(replies[i].dueMs - replies[ready].dueMs) < 0)) {
+                ready = i;
+            }
+        }
+        return ready == 0xFF ? 0 : 48;
+    }
+    int read(uint8_t* buffer, size_t length) {
+        if (ready == 0xFF) return 0;
+        memcpy(buffer, replies[ready].packet, length < 48 ? length : 48);
+        replies[ready].queued = false;
+        ready = 0xFF;
+        return 48;
+    }
+};
+
+using ScriptedClient = BasicNTPClient<ScriptedUdp, 4, FakeClock>;
+
+void test_basic_client_capacity_from_template(void) {
+    TinyClient client;
+
+    TEST_ASSERT_EQUAL_UINT8(2, TinyClient::MAX_SERVERS);
+    TEST_ASSERT_TRUE(client.addServer("a.example.com"));
+    TEST_ASSERT_TRUE(client.addServer("b.example.com"));
+    TEST_ASSERT_FALSE(client.addServer("c.example.com"));
+    TEST_ASSERT_TRUE(sizeof(TinyClient) < sizeof(BasicNTPClient<RecordingUdp, 10>));
+}
+
+void test_basic_client_sends_through_transport(void) {
+    BasicNTPClient<RecordingUdp, 2> client;
+    client.begin();
+    TEST_ASSERT_TRUE(client.addServer("a.example.com", 1123));
+
+    NTPClient::SyncResult result = client.syncTimeFromServer("a.example.com", 5);
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_TRUE(result.error == NTPClient::SyncError::TIMEOUT);
+    TEST_ASSERT_EQUAL_UINT8(0, result.serverIndex);
+    TEST_ASSERT_EQUAL_STRING("a.example.com", client.getServerName(result.serverIndex));
+    TEST_ASSERT_EQUAL_UINT8(1, client.getTransport().sent);
+    TEST_ASSERT_EQUAL_UINT16(1123, client.getTransport().lastPort);
+    TEST_ASSERT_EQUAL(48, client.getTransport().lastLength);
+
+    // Prebuilt request with only the transmit timestamp filled in
+    NTPPacketView sent(client.getTransport().packet);
+    TEST_ASSERT_EQUAL_UINT8(3, sent.mode());
+    TEST_ASSERT_EQUAL_UINT8(4, sent.version());
+    TEST_ASSERT_EQUAL_HEX32(0, sent.originSeconds());
+    TEST_ASSERT_TRUE(sent.transmitSeconds() > 2208988800UL);
+
+    // Transport-independent calls work on any client through the common base
+    NTPClientBase& base = client;
+    TEST_ASSERT_EQUAL_UINT32(0, base.getSyncCount());
+    client.end();
+}
+
+void test_sync_budget_includes_slow_lookup(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    ScriptedUdp& udp = client.getTransport();
+    udp.host("slow.example.com").lookupMs = 3000;
+    (void)client.addServer("slow.example.com");
+    client.begin();
+
+    // Only what the lookup left of the budget is spent waiting
+    uint32_t start = FakeClock::now;
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_LESS_OR_EQUAL(5001, FakeClock::now - start);
+
+    // A lookup that outlasts the budget ends the sync without waiting
+    udp.host("slow.example.com").lookupMs = 6000;
+    start = FakeClock::now;
+    result = client.syncTime(5000);
+    TEST_ASSERT_TRUE(result.error == NTPClient::SyncError::DEADLINE_EXCEEDED);
+    TEST_ASSERT_EQUAL_UINT32(6000, FakeClock::now - start);
+    client.end();
+}
+
+void test_sync_candidate_order(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    ScriptedUdp& udp = client.getTransport();
+    const char* names[] = { "a.example.com", "b.example.com", "c.example.com", "d.example.com" };
+    for (const char* name : names) {
+        (void)client.addServer(name);
+    }
+    udp.host("b.example.com").replyAfterMs = 20;
+    client.begin();
+
+    // No history yet: table order until one answers
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT8(1, result.serverIndex);
+    TEST_ASSERT_EQUAL_UINT16(1, udp.host("a.example.com").sent);
+    TEST_ASSERT_EQUAL_UINT16(1, udp.host("b.example.com").sent);
+
+    // The proven server goes first, then the others in table order
+    udp.host("b.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    udp.host("c.example.com").replyAfterMs = 20;
+    result = client.syncTime(5000);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT8(2, result.serverIndex);
+    TEST_ASSERT_EQUAL_UINT16(2, udp.host("a.example.com").sent);
+    TEST_ASSERT_EQUAL_UINT16(2, udp.host("b.example.com").sent);
+    TEST_ASSERT_EQUAL_UINT16(1, udp.host("c.example.com").sent);
+    TEST_ASSERT_EQUAL_UINT16(0, udp.host("d.example.com").sent);
+    client.end();
+}
+
+// Hedging client whose primary a.example.com has a 10 ms RTT history
+static void setUpHedgedClient(ScriptedClient& client) {
+    FakeClock::now = 1000;
+    ScriptedUdp& udp = client.getTransport();
+    (void)client.addServer("a.example.com");
+    (void)client.addServer("b.example.com");
+    client.begin();
+    client.setHedging(true);
+    udp.host("a.example.com").replyAfterMs = 10;
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(client.syncTime(5000).success);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, udp.host("b.example.com").sent);
+}
+
+void test_hedged_sync_primary_can_still_win(void) {
+    ScriptedClient client;
+    setUpHedgedClient(client);
+    ScriptedUdp& udp = client.getTransport();
+
+    // Past its p95 the runner-up is asked too, but the primary's own
+    // reply is still accepted when it comes first
+    udp.host("a.example.com").replyAfterMs = 200;
+    udp.host("b.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT8(0, result.serverIndex);
+    TEST_ASSERT_EQUAL_UINT16(1, udp.host("b.example.com").sent);
+    client.end();
+}
+
+void test_hedged_sync_runner_up_wins(void) {
+    ScriptedClient client;
+    setUpHedgedClient(client);
+    ScriptedUdp& udp = client.getTransport();
+
+    udp.host("a.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    udp.host("b.example.com").replyAfterMs = 20;
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_UINT8(1, result.serverIndex);
+    client.end();
+}
+
+void test_hedged_sync_slow_hedge_lookup_keeps_budget(void) {
+    ScriptedClient client;
+    setUpHedgedClient(client);
+    ScriptedUdp& udp = client.getTransport();
+
+    // The hedge's lookup outlasts the time left for the hedged attempt
+    udp.host("a.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    udp.host("b.example.com").lookupMs = 3000;
+    uint32_t start = FakeClock::now;
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_LESS_OR_EQUAL(5000, FakeClock::now - start);
+    client.end();
+}
+
+void test_hedged_sync_slow_primary_lookup_keeps_budget(void) {
+    ScriptedClient client;
+    setUpHedgedClient(client);
+    ScriptedUdp& udp = client.getTransport();
+
+    // The primary's lookup takes about the whole budget: the sync still
+    // ends in time, and the lookup is not held against the server
+    udp.host("a.example.com").lookupMs = 4990;
+    uint32_t start = FakeClock::now;
+    NTPClient::SyncResult result = client.syncTime(5000);
+    TEST_ASSERT_FALSE(result.success);
+    TEST_ASSERT_LESS_OR_EQUAL(5000, FakeClock::now - start);
+    TEST_ASSERT_EQUAL_UINT32(0, client.getServer(0)->failureCount);
+    client.end();
+}
+
+void test_hedged_sync_charges_silent_runner_up(void) {
+    ScriptedClient client;
+    setUpHedgedClient(client);
+    ScriptedUdp& udp = client.getTransport();
+
+    // The runner-up answers a hedge once...
+    udp.host("a.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    udp.host("b.example.com").replyAfterMs = 20;
+    TEST_ASSERT_TRUE(client.syncTime(5000).success);
+    TEST_ASSERT_EQUAL_UINT8(1, client.getServer(1)->reach);
+
+    // ...then goes silent too: both servers are charged for the loss
+    udp.host("b.example.com").replyAfterMs = ScriptedUdp::SILENT;
+    TEST_ASSERT_FALSE(client.syncTime(5000).success);
+    TEST_ASSERT_EQUAL_UINT16(2, udp.host("b.example.com").sent);
+    TEST_ASSERT_EQUAL_UINT32(1, client.getServer(1)->failureCount);
+    TEST_ASSERT_EQUAL_UINT8(2, client.getServer(1)->reach);
+    client.end();
+}
+
+// ============================================================================
+// Callback Tests
+// ============================================================================
+
+static int g_yieldCount = 0;
+static void countYield() { g_yieldCount++; }
+
+void test_inplace_function_stores_callables(void) {
+    NTPClient::YieldCallback empty;
+    TEST_ASSERT_FALSE(empty);
+
+    NTPClient::YieldCallback fromPointer(countYield);
+    NTPClient::YieldCallback copy = fromPointer;
+    copy();
+    fromPointer();
+    TEST_ASSERT_EQUAL_INT(2, g_yieldCount);
+
+    int total = 0;
+    NTPInplaceFunction<void(int)> add = [&total](int n) { total += n; };
+    NTPInplaceFunction<void(int)> moved = std::move(add);
+    TEST_ASSERT_FALSE(add);
+    moved(5);
+    moved(7);
+    TEST_ASSERT_EQUAL_INT(12, total);
+}
+
+void test_callback_list_multiple_subscribers(void) {
+    NTPCallbackList<void(time_t, time_t), 3> listeners;
+    int primary = 0;
+    int extra = 0;
+
+    listeners.setPrimary([&primary](time_t, time_t) { primary++; });
+    int8_t first = listeners.add([&extra](time_t, time_t) { extra++; });
+    int8_t second = listeners.add([&extra](time_t, time_t) { extra += 10; });
+    TEST_ASSERT_EQUAL_INT8(-1, listeners.add([](time_t, time_t) {}));  // Full
+
+    listeners(0, 1);
+    TEST_ASSERT_EQUAL_INT(1, primary);
+    TEST_ASSERT_EQUAL_INT(11, extra);
+
+    TEST_ASSERT_TRUE(listeners.remove(first));
+    TEST_ASSERT_FALSE(listeners.remove(first));
+    listeners.setPrimary(nullptr);
+    listeners(1, 2);
+    TEST_ASSERT_EQUAL_INT(1, primary);
+    TEST_ASSERT_EQUAL_INT(21, extra);
+    TEST_ASSERT_TRUE(listeners.remove(second));
+}
+
+void test_client_time_change_listeners(void) {
+    NTPClient client;
+    int calls = 0;
+
+    client.onTimeChange([&calls](time_t, time_t) { calls++; });
+    int8_t id = client.addTimeChangeListener([&calls](time_t, time_t) { calls += 100; });
+    TEST_ASSERT_TRUE(id > 0);
+
+    time_t now = time(nullptr);
+    client.setEpochTime(now);
+    TEST_ASSERT_EQUAL_INT(101, calls);
+
+    TEST_ASSERT_TRUE(client.removeTimeChangeListener(id));
+    client.setEpochTime(now);
+    TEST_ASSERT_EQUAL_INT(102, calls);
+}
+
+void test_deferred_callbacks_dispatched_from_process(void) {
+    NTPClient client;
+    int calls = 0;
+    client.onTimeChange([&calls](time_t, time_t) { calls++; });
+    client.setDeferredCallbacks(true);
+
+    client.setEpochTime(time(nullptr));
+    TEST_ASSERT_EQUAL_INT(0, calls);  // Queued, not run inline
+    TEST_ASSERT_TRUE(client.hasPendingCallbacks());
+    TEST_ASSERT_EQUAL_UINT32(0, client.getMillisUntilNextAction());
+
+    client.process();
+    TEST_ASSERT_EQUAL_INT(1, calls);
+    TEST_ASSERT_FALSE(client.hasPendingCallbacks());
+    TEST_ASSERT_EQUAL_UINT32(NTPClient::NO_PENDING_ACTION, client.getMillisUntilNextAction());
+}
+
+void test_deferred_callbacks_queue_overflow(void) {
+    NTPClient client;
+    int calls = 0;
+    client.onTimeChange([&calls](time_t, time_t) { calls++; });
+    client.setDeferredCallbacks(true, false);  // Dispatched by a worker, not process()
+
+    for (uint8_t i = 0; i < NTPClient::DEFERRED_QUEUE_SIZE + 2; i++) {
+        client.setEpochTime(time(nullptr));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, client.getDroppedCallbackCount());
+
+    client.process();
+    TEST_ASSERT_EQUAL_INT(0, calls);
+    TEST_ASSERT_EQUAL_UINT8(NTPClient::DEFERRED_QUEUE_SIZE, client.dispatchPendingCallbacks());
+    TEST_ASSERT_EQUAL_INT(NTPClient::DEFERRED_QUEUE_SIZE, calls);
+}
+
+// ============================================================================
+// Poll Timer Wheel Tests
+// ============================================================================
+
+void test_timer_wheel_fires_in_order(void) {
+    NTPTimerWheel<4> wheel;
+    uint8_t fired[4];
+    uint8_t count = 0;
+
+    wheel.schedule(0, 30);
+    wheel.schedule(1, 10);
+    wheel.schedule(2, 20);
+
+    wheel.advance(15, [&](uint8_t id) { fired[count++] = id; });
+    TEST_ASSERT_EQUAL_UINT8(1, count);
+    TEST_ASSERT_EQUAL_UINT8(1, fired[0]);
+
+    wheel.advance(30, [&](uint8_t id) { fired[count++] = id; });
+    TEST_ASSERT_EQUAL_UINT8(3, count);
+    TEST_ASSERT_EQUAL_UINT8(2, fired[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, fired[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, wheel.armedCount());
+}
+
+void test_timer_wheel_cascades_long_delays(void) {
+    NTPTimerWheel<4> wheel;
+    uint32_t firedAt = 0;
+
+    // 1 hour lands in the second level, 2 days in the third
+    wheel.schedule(0, 3600);
+    wheel.schedule(1, 172800);
+
+    wheel.advance(3599, [&](uint8_t) { firedAt = 1; });
+    TEST_ASSERT_EQUAL_UINT32(0, firedAt);
+    wheel.advance(3600, [&](uint8_t id) { if (id == 0) firedAt = wheel.now(); });
+    TEST_ASSERT_EQUAL_UINT32(3600, firedAt);
+
+    wheel.advance(172800, [&](uint8_t id) { if (id == 1) firedAt = wheel.now(); });
+    TEST_ASSERT_EQUAL_UINT32(172800, firedAt);
+}
+
+void test_timer_wheel_beyond_range_and_reschedule(void) {
+    NTPTimerWheel<4> wheel;
+    uint32_t firedAt = 0;
+    uint8_t fires = 0;
+
+    // Beyond the wheel range: parked and re-cascaded until due
+    uint32_t due = NTPTimerWheel<4>::RANGE + 5000;
+    wheel.schedule(3, due);
+    wheel.advance(due, [&](uint8_t) { firedAt = wheel.now(); fires++; });
+    TEST_ASSERT_EQUAL_UINT32(due, firedAt);
+    TEST_ASSERT_EQUAL_UINT8(1, fires);
+
+    // Re-scheduling from the callback keeps a periodic entry alive
+    fires = 0;
+    wheel.schedule(0, wheel.now() + 60);
+    wheel.advance(wheel.now() + 600, [&](uint8_t id) {
+        fires++;
+        wheel.schedule(id, wheel.now() + 60);
+    });
+    TEST_ASSERT_EQUAL_UINT8(10, fires);
+    TEST_ASSERT_TRUE(wheel.isArmed(0));
+}
+
+void test_sync_jitter_phase_is_deterministic_per_seed(void) {
+    NTPClient a, b, c;
+    NTPClient* clients[] = { &a, &b, &c };
+    const uint32_t seeds[] = { 42, 42, 4242 };
+
+    for (uint8_t i = 0; i < 3; i++) {
+        clients[i]->setJitterSeed(seeds[i]);
+        clients[i]->setSyncJitter(600, 10);
+        (void)clients[i]->addServer("pool.ntp.org");
+        clients[i]->setAutoSync(true, 3600);
+    }
+
+    time_t now = time(nullptr);
+    TEST_ASSERT_TRUE(a.getNextSyncTime() >= now);
+    TEST_ASSERT_TRUE(a.getNextSyncTime() <= now + 601);
+    TEST_ASSERT_EQUAL(a.getNextSyncTime(), b.getNextSyncTime());
+    TEST_ASSERT_TRUE(a.getNextSyncTime() != c.getNextSyncTime());
+}
+
+void test_added_server_uses_first_sync_phase(void) {
+    ScriptedClient a, b;
+    ScriptedClient* clients[] = { &a, &b };
+    const uint32_t seeds[] = { 42, 4242 };
+
+    for (uint8_t i = 0; i < 2; i++) {
+        FakeClock::now = 1000;
+        clients[i]->begin();
+        clients[i]->setJitterSeed(seeds[i]);
+        clients[i]->setSyncJitter(600, 0);
+        clients[i]->setAutoSync(true, 3600);
+
+        // With no servers the first sync fails and is retried in a minute
+        FakeClock::now += clients[i]->getMillisUntilNextAction();
+        clients[i]->process();
+        TEST_ASSERT_EQUAL_UINT32(60000, clients[i]->getMillisUntilNextAction());
+
+        // The first server restarts it at the per-device phase
+        (void)clients[i]->addServer("pool.ntp.org");
+        TEST_ASSERT_LESS_OR_EQUAL(601000, clients[i]->getMillisUntilNextAction());
+    }
+    TEST_ASSERT_TRUE(a.getMillisUntilNextAction() != b.getMillisUntilNextAction());
+}
+
+void test_rate_kiss_is_not_a_failure(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    ScriptedUdp::Host& host = client.getTransport().host("a.example.com");
+    host.replyAfterMs = 10;
+    host.kissCode = NTPClient::KISS_RATE;
+    (void)client.addServer("a.example.com");
+    client.begin();
+
+    // Each kiss is answered with a longer holdoff, never with demotion
+    for (uint8_t i = 1; i <= 4; i++) {
+        TEST_ASSERT_FALSE(client.syncTime(5000).success);
+        const NTPClient::NTPServer* server = client.getServer(0);
+        TEST_ASSERT_EQUAL_HEX32(NTPClient::KISS_RATE, server->kissCode);
+        TEST_ASSERT_TRUE(server->reachable);
+        TEST_ASSERT_EQUAL_UINT32(0, server->failureCount);
+        TEST_ASSERT_EQUAL_UINT8(i, server->rateBackoff);
+        TEST_ASSERT_TRUE(server->heldOff(FakeClock::now));
+        FakeClock::now = server->holdoffUntilMs;
+    }
+    TEST_ASSERT_EQUAL_UINT16(4, host.sent);
+    client.end();
+}
+
+void test_probe_waits_out_rate_holdoff(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    ScriptedUdp::Host& host = client.getTransport().host("a.example.com");
+    host.replyAfterMs = 10;
+    host.kissCode = NTPClient::KISS_RATE;
+    (void)client.addServer("a.example.com");
+    client.begin();
+    client.setSyncJitter(0, 0);
+    client.setAutoSync(true, 3600);
+    TEST_ASSERT_TRUE(client.setServerPollInterval("a.example.com", 60));
+
+    // The start-up sync is kissed: 120s of holdoff, in which neither the
+    // one-minute probes nor the sync retries may ask again
+    uint32_t end = FakeClock::now + 119000;
+    while ((int32_t)(FakeClock::now - end) < 0) {
+        client.process();
+        FakeClock::now += 1000;
+    }
+    TEST_ASSERT_EQUAL_UINT16(1, host.sent);
+
+    // Afterwards the server is asked again
+    end = FakeClock::now + 10000;
+    while ((int32_t)(FakeClock::now - end) < 0) {
+        client.process();
+        FakeClock::now += 1000;
+    }
+    TEST_ASSERT_TRUE(host.sent > 1);
+    client.end();
+}
+
+void test_millis_until_next_action(void) {
+    NTPClient client;
+
+    TEST_ASSERT_EQUAL_UINT32(NTPClient::NO_PENDING_ACTION, client.getMillisUntilNextAction());
+
+    client.begin();
+    (void)client.addServer("pool.ntp.org");
+    TEST_ASSERT_EQUAL_UINT32(NTPClient::NO_PENDING_ACTION, client.getMillisUntilNextAction());
+
+    // The first sync is due on the next wheel tick
+    client.setAutoSync(true, 3600);
+    TEST_ASSERT_LESS_OR_EQUAL(1000, client.getMillisUntilNextAction());
+
+    client.setAutoSync(false);
+    TEST_ASSERT_EQUAL_UINT32(NTPClient::NO_PENDING_ACTION, client.getMillisUntilNextAction());
+    client.end();
+}
+
+void test_unreachable_server_is_reprobed(void) {
+    NTPClient client;
+    client.begin();
+    (void)client.addServer("192.0.2.1");  // TEST-NET-1, never answers
+
+    // Three lost replies mark the server unreachable
+    for (int i = 0; i < 3; i++) {
+        (void)client.syncTime(20);
+    }
+    auto servers = client.getServers();
+    TEST_ASSERT_FALSE(servers[0].reachable);
+    TEST_ASSERT_EQUAL_UINT8(0, servers[0].reach);
+
+    // A background re-probe is scheduled even without auto-sync
+    uint32_t untilProbe = client.getMillisUntilNextAction();
+    TEST_ASSERT_TRUE(untilProbe > 60000);
+    TEST_ASSERT_TRUE(untilProbe <= 64000);
+    client.end();
+}
+
+void test_timer_wheel_reset_from_fire_stops_advance(void) {
+    NTPTimerWheel<4> wheel;
+    uint8_t fires = 0;
+
+    // A callback that moves the wheel past the target must not make
+    // advance() walk round the whole tick space
+    wheel.schedule(0, 10);
+    wheel.schedule(1, 50);
+    wheel.advance(20, [&](uint8_t) {
+        fires++;
+        wheel.reset(25);
+        wheel.schedule(1, 30);
+    });
+    TEST_ASSERT_EQUAL_UINT8(1, fires);
+    TEST_ASSERT_EQUAL_UINT32(25, wheel.now());
+    TEST_ASSERT_EQUAL_UINT32(30, wheel.dueTick(1));
+}
+
+void test_process_polls_silent_server_once(void) {
+    FakeClock::now = 5000;
+    ScriptedClient client;
+    client.begin();
+    (void)client.addServer("silent.example.com");
+    client.setSyncJitter(0, 0);
+    client.setAutoSync(true, 3600);
+
+    // The poll is due on the next tick; one process() sends one request
+    // and gives up after its timeout
+    FakeClock::now += client.getMillisUntilNextAction();
+    uint32_t start = FakeClock::now;
+    client.process();
+    TEST_ASSERT_EQUAL_UINT16(1, client.getTransport().sent);
+    TEST_ASSERT_LESS_OR_EQUAL(6000, FakeClock::now - start);
+
+    // Nothing else is due straight away, even though the poll overran
+    // several wheel ticks
+    TEST_ASSERT_TRUE(client.getMillisUntilNextAction() >= 1000);
+    client.process();
+    TEST_ASSERT_EQUAL_UINT16(1, client.getTransport().sent);
+    client.end();
+}
+
+void test_auto_sync_steps_clock_once_per_interval(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    ScriptedUdp& udp = client.getTransport();
+    const char* names[] = { "a.example.com", "b.example.com", "c.example.com", "d.example.com" };
+    for (const char* name : names) {
+        udp.host(name).replyAfterMs = 20;
+        (void)client.addServer(name);
+    }
+    udp.host("a.example.com").replyAfterMs = ScriptedUdp::SILENT;
+
+    uint8_t syncs = 0;
+    client.onSync([&](const NTPClient::SyncResult& result) { syncs += result.success; });
+    client.begin();
+    client.setSyncJitter(0, 0);
+    client.setAutoSync(true, 3600);
+
+    // Two hours: a sync at start-up and one per hour, each failing over
+    // from the silent server within the same sync when needed
+    uint32_t end = FakeClock::now + 2 * 3600 * 1000UL + 5000;
+    while ((int32_t)(FakeClock::now - end) < 0) {
+        client.process();
+        FakeClock::now += 1000;
+    }
+    TEST_ASSERT_EQUAL_UINT8(3, syncs);
+    TEST_ASSERT_TRUE(udp.host("a.example.com").sent >= 1);
+    TEST_ASSERT_LESS_OR_EQUAL(6, udp.sent);
+    TEST_ASSERT_EQUAL_UINT16(0, udp.host("d.example.com").sent);
+    client.end();
+}
+
+void test_manual_sync_restarts_auto_sync_interval(void) {
+    FakeClock::now = 1000;
+    ScriptedClient client;
+    client.getTransport().host("a.example.com").replyAfterMs = 20;
+    (void)client.addServer("a.example.com");
+    client.begin();
+    client.setSyncJitter(0, 0);
+    client.setAutoSync(true, 3600);
+    TEST_ASSERT_LESS_OR_EQUAL(1000, client.getMillisUntilNextAction());
+
+    // The user's own sync counts; no automatic one follows straight away
+    TEST_ASSERT_TRUE(client.syncTime().success);
+    TEST_ASSERT_TRUE(client.getMillisUntilNextAction() > 3590 * 1000UL);
+    client.process();
+    TEST_ASSERT_EQUAL_UINT16(1, client.getTransport().sent);
+    client.end();
+}
+
 // ============================================================================
 // Test Runner
 // ============================================================================
@@ -450,15 +1712,21 @@ void runAllTests() {
     // NTPPacket tests
     RUN_TEST(test_ntp_packet_size);
     RUN_TEST(test_ntp_packet_packed);
+    RUN_TEST(test_packet_view_decodes_in_place);
+    RUN_TEST(test_request_template_is_constant);
 
     // SyncResult tests
     RUN_TEST(test_sync_result_default_constructor);
     RUN_TEST(test_sync_result_usec_field);
-    RUN_TEST(test_sync_result_server_buffer_size);
-    RUN_TEST(test_sync_result_error_buffer_size);
+    RUN_TEST(test_sync_result_compact);
+    RUN_TEST(test_sync_result_to_string);
 
     // NTPServer tests
     RUN_TEST(test_ntp_server_structure);
+    RUN_TEST(test_ntp_server_rto_tracks_fast_server);
+    RUN_TEST(test_ntp_server_rto_first_sample_and_backoff);
+    RUN_TEST(test_kiss_code_to_string);
+    RUN_TEST(test_ntp_server_usable_respects_kiss_state);
 
     // TimeZoneConfig tests
     RUN_TEST(test_timezone_config_structure);
@@ -466,6 +1734,19 @@ void runAllTests() {
     RUN_TEST(test_timezone_est);
     RUN_TEST(test_timezone_pst);
     RUN_TEST(test_timezone_cet);
+    RUN_TEST(test_dst_lookup_across_years);
+    RUN_TEST(test_posix_tz_parses_rules);
+    RUN_TEST(test_posix_tz_rejects_malformed);
+    RUN_TEST(test_posix_tz_transitions);
+    RUN_TEST(test_compiled_zone_lookup);
+    RUN_TEST(test_client_uses_compiled_zone);
+    RUN_TEST(test_time_zone_handles_independent);
+    RUN_TEST(test_rfc3339_formatting);
+    RUN_TEST(test_format_memo_steps_in_place);
+    RUN_TEST(test_format_time_into_caller_buffer);
+    RUN_TEST(test_fixed_format_compiles_fields);
+    RUN_TEST(test_batch_conversion);
+    RUN_TEST(test_rfc3339_parsing);
 
     // Static utility tests
     RUN_TEST(test_is_leap_year_2020);
@@ -483,7 +1764,10 @@ void runAllTests() {
     RUN_TEST(test_days_in_december);
     RUN_TEST(test_make_time_basic);
     RUN_TEST(test_make_time_2024);
+    RUN_TEST(test_make_time_normalizes_fields);
     RUN_TEST(test_epoch_to_string_format);
+    RUN_TEST(test_calendar_round_trip);
+    RUN_TEST(test_make_time_ignores_tz_environment);
 
     // NTP fractional seconds conversion tests
     RUN_TEST(test_ntp_fraction_half_second);
@@ -509,9 +1793,39 @@ void runAllTests() {
     RUN_TEST(test_client_default_construction);
     RUN_TEST(test_client_initial_state);
     RUN_TEST(test_client_get_servers_empty_initially);
+    RUN_TEST(test_client_server_table_fixed_capacity);
+    RUN_TEST(test_basic_client_capacity_from_template);
+    RUN_TEST(test_basic_client_sends_through_transport);
+    RUN_TEST(test_sync_budget_includes_slow_lookup);
+    RUN_TEST(test_sync_candidate_order);
+    RUN_TEST(test_hedged_sync_primary_can_still_win);
+    RUN_TEST(test_hedged_sync_runner_up_wins);
+    RUN_TEST(test_hedged_sync_slow_hedge_lookup_keeps_budget);
+    RUN_TEST(test_hedged_sync_slow_primary_lookup_keeps_budget);
+    RUN_TEST(test_hedged_sync_charges_silent_runner_up);
+    RUN_TEST(test_inplace_function_stores_callables);
+    RUN_TEST(test_callback_list_multiple_subscribers);
+    RUN_TEST(test_client_time_change_listeners);
+    RUN_TEST(test_deferred_callbacks_dispatched_from_process);
+    RUN_TEST(test_deferred_callbacks_queue_overflow);
     RUN_TEST(test_client_timezone_default);
     RUN_TEST(test_client_reset_statistics);
 
+    // Poll timer wheel tests
+    RUN_TEST(test_timer_wheel_fires_in_order);
+    RUN_TEST(test_timer_wheel_cascades_long_delays);
+    RUN_TEST(test_timer_wheel_beyond_range_and_reschedule);
+    RUN_TEST(test_timer_wheel_reset_from_fire_stops_advance);
+    RUN_TEST(test_sync_jitter_phase_is_deterministic_per_seed);
+    RUN_TEST(test_added_server_uses_first_sync_phase);
+    RUN_TEST(test_rate_kiss_is_not_a_failure);
+    RUN_TEST(test_probe_waits_out_rate_holdoff);
+    RUN_TEST(test_millis_until_next_action);
+    RUN_TEST(test_unreachable_server_is_reprobed);
+    RUN_TEST(test_process_polls_silent_server_once);
+    RUN_TEST(test_auto_sync_steps_clock_once_per_interval);
+    RUN_TEST(test_manual_sync_restarts_auto_sync_interval);
+
     UNITY_END();
 }
 
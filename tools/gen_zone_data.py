@@ -0,0 +1,421 @@
+#!/usr/bin/env python3
+"""Compile selected IANA time zones into src/NTPZoneData.h.
+
+Reads the binary TZif files of the system tz database (or --zoneinfo DIR)
+and emits const tables that live in flash:
+
+  * NTP_ZONE_OFFSETS   - UTC offsets in minutes, shared by all zones
+  * NTP_ZONE_BLOCKS    - absolute checkpoints (UTC seconds) for binary search
+  * NTP_ZONE_DELTAS    - per-transition delta from the previous one in the
+                         same block, in quarter hours
+  * NTP_ZONE_TYPES     - per-transition offset index, bit 7 set during DST
+  * NTP_ZONES          - per-zone ranges into the tables plus the POSIX TZ
+                         rule that takes over after the explicit transitions
+
+Transitions from 1970 on are kept until the zone's POSIX footer rule
+reproduces them; later instants are computed from the rule at runtime.
+
+Usage:
+  tools/gen_zone_data.py [--zoneinfo /usr/share/zoneinfo] [-o src/NTPZoneData.h] [ZONE ...]
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+DEFAULT_ZONES = [
+    "UTC",
+    "Europe/London",
+    "Europe/Berlin",
+    "Europe/Paris",
+    "Europe/Madrid",
+    "Europe/Moscow",
+    "America/New_York",
+    "America/Chicago",
+    "America/Denver",
+    "America/Phoenix",
+    "America/Los_Angeles",
+    "America/Sao_Paulo",
+    "Asia/Kolkata",
+    "Asia/Kathmandu",
+    "Asia/Shanghai",
+    "Asia/Tokyo",
+    "Australia/Sydney",
+    "Pacific/Auckland",
+]
+
+QUARTER_HOUR = 900
+BLOCK_SIZE = 16          # Transitions per binary-search checkpoint at most
+MAX_DELTA = 0xFFFF       # Quarter hours that fit in a delta (~1.87 years)
+UINT32_MAX = 0xFFFFFFFF
+
+
+# ---------------------------------------------------------------------------
+# TZif reader (RFC 8536)
+# ---------------------------------------------------------------------------
+
+def read_tzif(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"TZif":
+        raise ValueError(f"{path}: not a TZif file")
+    version = data[4:5]
+
+    def header(offset):
+        return struct.unpack(">6l", data[offset + 20:offset + 44])
+
+    isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt = header(0)
+    if version == b"\0":
+        raise ValueError(f"{path}: version 1 TZif files are not supported")
+
+    # Skip the 32-bit block, parse the 64-bit one
+    offset = 44 + timecnt * 5 + typecnt * 6 + charcnt + leapcnt * 8 + isstdcnt + isutcnt
+    isutcnt, isstdcnt, leapcnt, timecnt, typecnt, charcnt = header(offset)
+    offset += 44
+    times = struct.unpack(f">{timecnt}q", data[offset:offset + timecnt * 8])
+    offset += timecnt * 8
+    indices = data[offset:offset + timecnt]
+    offset += timecnt
+    types = []
+    for _ in range(typecnt):
+        utoff, isdst, _abbr = struct.unpack(">lBB", data[offset:offset + 6])
+        types.append((utoff, bool(isdst)))
+        offset += 6
+    offset += charcnt + leapcnt * 12 + isstdcnt + isutcnt
+    footer = data[offset:].strip(b"\n").decode("ascii")
+
+    transitions = [(t, types[i]) for t, i in zip(times, indices)]
+    return transitions, types, footer
+
+
+# ---------------------------------------------------------------------------
+# POSIX TZ rule evaluation, mirroring NTPClientBase::parseTimeZone()
+# ---------------------------------------------------------------------------
+
+def _days_from_civil(y, m, d):
+    y -= m <= 2
+    era = (y if y >= 0 else y - 399) // 400
+    yoe = y - era * 400
+    doy = (153 * (m - 3 if m > 2 else m + 9) + 2) // 5 + d - 1
+    doe = yoe * 365 + yoe // 4 - yoe // 100 + doy
+    return era * 146097 + doe - 719468
+
+
+def _is_leap(y):
+    return (y % 4 == 0 and y % 100 != 0) or y % 400 == 0
+
+
+class PosixRule:
+    def __init__(self, text):
+        self.text = text
+        self.pos = 0
+        self.std_name = self._name()
+        self.std_offset = -self._time()
+        self.dst_name = None
+        self.rules = None
+        if self.pos < len(text):
+            self.dst_name = self._name()
+            self.dst_offset = self.std_offset + 3600
+            if self.pos < len(text) and text[self.pos] != ",":
+                self.dst_offset = -self._time()
+            if self.pos < len(text):
+                self._expect(",")
+                start = self._date()
+                self._expect(",")
+                end = self._date()
+                self.rules = (start, end)
+            else:
+                self.rules = (("M", 3, 2, 0, 7200), ("M", 11, 1, 0, 7200))
+        if self.pos != len(text):
+            raise ValueError(f"bad POSIX TZ rule {text!r}")
+
+    def _expect(self, c):
+        if self.text[self.pos:self.pos + 1] != c:
+            raise ValueError(f"bad POSIX TZ rule {self.text!r}")
+        self.pos += 1
+
+    def _number(self):
+        start = self.pos
+        while self.pos < len(self.text) and self.text[self.pos].isdigit():
+            self.pos += 1
+        if start == self.pos:
+            raise ValueError(f"bad POSIX TZ rule {self.text!r}")
+        return int(self.text[start:self.pos])
+
+    def _name(self):
+        if self.text[self.pos] == "<":
+            end = self.text.index(">", self.pos)
+            name = self.text[self.pos + 1:end]
+            self.pos = end + 1
+        else:
+            start = self.pos
+            while self.pos < len(self.text) and self.text[self.pos].isalpha():
+                self.pos += 1
+            name = self.text[start:self.pos]
+        if len(name) < 3:
+            raise ValueError(f"bad POSIX TZ rule {self.text!r}")
+        return name
+
+    def _time(self):
+        sign = 1
+        if self.text[self.pos] in "+-":
+            sign = -1 if self.text[self.pos] == "-" else 1
+            self.pos += 1
+        seconds = self._number() * 3600
+        for scale in (60, 1):
+            if self.text[self.pos:self.pos + 1] != ":":
+                break
+            self.pos += 1
+            seconds += self._number() * scale
+        return sign * seconds
+
+    def _date(self):
+        c = self.text[self.pos]
+        if c == "M":
+            self.pos += 1
+            month = self._number()
+            self._expect(".")
+            week = self._number()
+            self._expect(".")
+            day = self._number()
+            rule = ("M", month, week, day)
+        elif c == "J":
+            self.pos += 1
+            rule = ("J", self._number())
+        else:
+            rule = ("N", self._number())
+        seconds = 7200
+        if self.text[self.pos:self.pos + 1] == "/":
+            self.pos += 1
+            seconds = self._time()
+        return rule + (seconds,)
+
+    def _transition(self, year, rule, offset):
+        kind = rule[0]
+        days = _days_from_civil(year, 1, 1)
+        if kind == "J":
+            days += rule[1] - 1 + (1 if rule[1] >= 60 and _is_leap(year) else 0)
+        elif kind == "N":
+            days += rule[1]
+        else:
+            _, month, week, dow, _ = rule
+            first = _days_from_civil(year, month, 1)
+            first_dow = (first + 4) % 7
+            day = 1 + (dow - first_dow + 7) % 7 + (week - 1) * 7
+            dim = [31, 29 if _is_leap(year) else 28, 31, 30, 31, 30,
+                   31, 31, 30, 31, 30, 31][month - 1]
+            while day > dim:
+                day -= 7
+            days = first + day - 1
+        return days * 86400 + rule[-1] - offset
+
+    def offset_at(self, t):
+        """(utoff seconds, isdst) in effect at UTC instant t."""
+        if self.rules is None:
+            return (self.std_offset, False)
+        year = 1970 + t // 31556952
+        events = []
+        for y in (year - 1, year, year + 1):
+            events.append((self._transition(y, self.rules[0], self.std_offset), True))
+            events.append((self._transition(y, self.rules[1], self.dst_offset), False))
+        events.sort()
+        dst = not events[0][1]
+        for when, to_dst in events:
+            if when > t:
+                break
+            dst = to_dst
+        return (self.dst_offset, True) if dst else (self.std_offset, False)
+
+
+# ---------------------------------------------------------------------------
+# Compilation
+# ---------------------------------------------------------------------------
+
+def compile_zone(name, zoneinfo):
+    transitions, types, footer = read_tzif(os.path.join(zoneinfo, name))
+    rule = PosixRule(footer) if footer else None
+
+    # Offset in effect at 1970-01-01, then the transitions after it
+    initial = next((t for t in types if not t[1]), types[0])
+    kept = []
+    for when, tt in transitions:
+        if when <= 0:
+            initial = tt
+        elif when <= UINT32_MAX:
+            kept.append((when, tt))
+
+    # Drop trailing no-op transitions (fat TZif files end with one at 2^31-1)
+    while kept and kept[-1][1] == (kept[-2][1] if len(kept) >= 2 else initial):
+        kept.pop()
+
+    # Drop the tail the footer rule reproduces
+    footer_from = UINT32_MAX
+    if rule is not None:
+        cut = len(kept)
+        while cut > 0:
+            when, tt = kept[cut - 1]
+            before = kept[cut - 2][1] if cut >= 2 else initial
+            if rule.offset_at(when) != tt or rule.offset_at(when - 1) != before:
+                break
+            cut -= 1
+        if cut < len(kept):
+            footer_from = kept[cut][0]
+        elif kept:
+            footer_from = kept[-1][0]
+        else:
+            footer_from = 0
+        kept = kept[:cut]
+
+    for when, tt in kept:
+        if when % QUARTER_HOUR:
+            raise ValueError(f"{name}: transition {when} is not on a quarter hour")
+    return {
+        "name": name,
+        "posix": footer,
+        "initial": initial,
+        "transitions": kept,
+        "footer_from": footer_from,
+    }
+
+
+def encode(zones):
+    offsets = []
+    blocks, deltas, type_codes, entries = [], [], [], []
+
+    def type_code(tt):
+        utoff, isdst = tt
+        if utoff % 60:
+            raise ValueError(f"offset {utoff}s is not a whole minute")
+        minutes = utoff // 60
+        if minutes not in offsets:
+            offsets.append(minutes)
+        return offsets.index(minutes) | (0x80 if isdst else 0)
+
+    for zone in zones:
+        first_block = len(blocks)
+        first_transition = len(deltas)
+        previous = None
+        in_block = 0
+        for when, tt in zone["transitions"]:
+            if previous is None or in_block == BLOCK_SIZE or \
+                    (when - previous) // QUARTER_HOUR > MAX_DELTA:
+                blocks.append((when, len(deltas)))
+                deltas.append(0)
+                in_block = 1
+            else:
+                deltas.append((when - previous) // QUARTER_HOUR)
+                in_block += 1
+            type_codes.append(type_code(tt))
+            previous = when
+        entries.append((zone, type_code(zone["initial"]), first_block, len(blocks) - first_block,
+                        first_transition, len(deltas) - first_transition))
+    if len(offsets) > 0x7F:
+        raise ValueError("too many distinct offsets for the 7-bit type index")
+    return offsets, blocks, deltas, type_codes, entries
+
+
+def enum_name(zone):
+    return "NTP_ZONE_" + "".join(c if c.isalnum() else "_" for c in zone.upper())
+
+
+def wrap(values, per_line=12, indent="    "):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ", ".join(values[i:i + per_line]) + ",")
+    return "\n".join(lines)
+
+
+def emit(zones, out):
+    offsets, blocks, deltas, type_codes, entries = encode(zones)
+    size = 2 * len(offsets) + 8 * len(blocks) + 2 * len(deltas) + len(type_codes)
+    lines = [
+        "// Generated by tools/gen_zone_data.py - do not edit.",
+        "// " + " ".join(os.path.basename(a) if i == 0 else a for i, a in enumerate(sys.argv)),
+        "",
+        "#ifndef NTP_ZONE_DATA_H",
+        "#define NTP_ZONE_DATA_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "// Compiled IANA zones",
+        "enum NTPZoneId : uint8_t {",
+    ]
+    for zone, *_ in entries:
+        lines.append(f"    {enum_name(zone['name'])},")
+    lines += [
+        "    NTP_ZONE_COUNT,",
+        "    NTP_ZONE_NONE = 0xFF",
+        "};",
+        "",
+        "struct NTPZoneBlock {",
+        "    uint32_t start;       // UTC seconds of the block's first transition",
+        "    uint16_t first;       // Index of that transition in NTP_ZONE_DELTAS/TYPES",
+        "};",
+        "",
+        "struct NTPZoneEntry {",
+        "    const char* name;     // IANA id",
+        "    const char* posixTZ;  // Rule in effect from footerFrom on",
+        "    uint32_t footerFrom;  // UTC seconds; explicit transitions end here",
+        "    uint16_t firstBlock;",
+        "    uint16_t firstTransition;",
+        "    uint8_t blockCount;",
+        "    uint8_t transitionCount;",
+        "    uint8_t initialType;  // Offset index before the first transition (bit 7: DST)",
+        "};",
+        "",
+        "static constexpr uint8_t NTP_ZONE_DST_FLAG = 0x80;",
+        f"static constexpr uint16_t NTP_ZONE_DELTA_UNIT = {QUARTER_HOUR};  // Seconds per delta step",
+        "",
+        f"// {size} bytes of transition data for {len(entries)} zones",
+        "inline constexpr int16_t NTP_ZONE_OFFSETS[] = {",
+        wrap([str(o) for o in offsets]),
+        "};",
+        "",
+        "inline constexpr NTPZoneBlock NTP_ZONE_BLOCKS[] = {",
+        wrap([f"{{{when}, {first}}}" for when, first in blocks] or ["{0, 0}"], per_line=4),
+        "};",
+        "",
+        "inline constexpr uint16_t NTP_ZONE_DELTAS[] = {",
+        wrap([str(d) for d in deltas] or ["0"]),
+        "};",
+        "",
+        "inline constexpr uint8_t NTP_ZONE_TYPES[] = {",
+        wrap([f"0x{c:02X}" for c in type_codes] or ["0"]),
+        "};",
+        "",
+        "inline constexpr NTPZoneEntry NTP_ZONES[NTP_ZONE_COUNT] = {",
+    ]
+    for zone, initial, first_block, block_count, first_transition, count in entries:
+        if block_count > 0xFF or count > 0xFF:
+            raise ValueError(f"{zone['name']}: too many transitions")
+        lines.append(f"    {{\"{zone['name']}\", \"{zone['posix']}\", {zone['footer_from']}UL, "
+                     f"{first_block}, {first_transition}, {block_count}, {count}, 0x{initial:02X}}},")
+    lines += [
+        "};",
+        "",
+        "#endif // NTP_ZONE_DATA_H",
+        "",
+    ]
+    with open(out, "w") as f:
+        f.write("\n".join(lines))
+    return size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("zones", nargs="*", default=DEFAULT_ZONES)
+    parser.add_argument("--zoneinfo", default="/usr/share/zoneinfo")
+    parser.add_argument("-o", "--output",
+                        default=os.path.join(os.path.dirname(__file__), "..", "src", "NTPZoneData.h"))
+    args = parser.parse_args()
+
+    zones = [compile_zone(name, args.zoneinfo) for name in args.zones]
+    size = emit(zones, args.output)
+    for zone in zones:
+        print(f"{zone['name']:24} {len(zone['transitions']):3} transitions, then {zone['posix']}")
+    print(f"{size} bytes of transition data")
+
+
+if __name__ == "__main__":
+    main()